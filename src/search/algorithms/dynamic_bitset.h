@@ -17,7 +17,7 @@ class DynamicBitset {
         "Block type must be unsigned");
 
     std::vector<Block> blocks;
-    const std::size_t num_bits;
+    std::size_t num_bits;
 
     static const Block zeros;
     static const Block ones;
@@ -123,6 +123,79 @@ public:
         }
         return true;
     }
+
+    bool none() const {
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            if (blocks[i])
+                return false;
+        }
+        return true;
+    }
+
+    DynamicBitset &operator&=(const DynamicBitset &other) {
+        assert(size() == other.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] &= other.blocks[i];
+        }
+        return *this;
+    }
+
+    DynamicBitset &operator|=(const DynamicBitset &other) {
+        assert(size() == other.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] |= other.blocks[i];
+        }
+        return *this;
+    }
+
+    // Set difference: removes all bits that are set in other.
+    DynamicBitset &operator-=(const DynamicBitset &other) {
+        assert(size() == other.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] &= ~other.blocks[i];
+        }
+        return *this;
+    }
+
+    /*
+      Return the position of the first set bit, or size() if no bit is
+      set. Together with find_next, this allows iterating over the set
+      bits while skipping empty blocks.
+    */
+    std::size_t find_first() const {
+        return find_from_block(0);
+    }
+
+    // Return the position of the first set bit after pos, or size().
+    std::size_t find_next(std::size_t pos) const {
+        ++pos;
+        if (pos >= num_bits)
+            return num_bits;
+        std::size_t block = block_index(pos);
+        Block remaining = blocks[block] & (ones << bit_index(pos));
+        if (remaining)
+            return block * bits_per_block + lowest_bit(remaining);
+        return find_from_block(block + 1);
+    }
+
+private:
+    static int lowest_bit(Block block) {
+        assert(block);
+        int pos = 0;
+        while (!(block & Block(1))) {
+            block >>= 1;
+            ++pos;
+        }
+        return pos;
+    }
+
+    std::size_t find_from_block(std::size_t first_block) const {
+        for (std::size_t i = first_block; i < blocks.size(); ++i) {
+            if (blocks[i])
+                return i * bits_per_block + lowest_bit(blocks[i]);
+        }
+        return num_bits;
+    }
 };
 
 template<typename Block>
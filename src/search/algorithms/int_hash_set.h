@@ -292,6 +292,17 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Return the key in the hash set that is equal to the given key, or -1 if
+      there is no such key. In contrast to insert(), the given key is never
+      added to the hash set, so it does not have to be a valid key for the
+      hasher and equality tester after the call.
+    */
+    KeyType find(KeyType key) const {
+        assert(key >= 0);
+        return find_equal_key(key, hasher(key));
+    }
+
     void dump(utils::LogProxy &log) const {
         int num_buckets = capacity();
         log << "[";
@@ -1,5 +1,7 @@
 #include "int_packer.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
 using namespace std;
@@ -58,6 +60,18 @@ public:
     ~VariableInfo() {
     }
 
+    int get_bin_index() const {
+        return bin_index;
+    }
+
+    int get_shift() const {
+        return shift;
+    }
+
+    Bin get_unshifted_mask() const {
+        return read_mask >> shift;
+    }
+
     int get(const Bin *buffer) const {
         return (buffer[bin_index] & read_mask) >> shift;
     }
@@ -70,9 +84,20 @@ public:
 };
 
 
-IntPacker::IntPacker(const vector<int> &ranges)
-    : num_bins(0) {
-    pack_bins(ranges);
+IntPacker::IntPacker(const vector<int> &ranges, bool byte_aligned)
+    : num_bins(0),
+      uses_one_byte_per_var(false) {
+    if (byte_aligned) {
+        pack_bins_byte_aligned(ranges);
+        uses_one_byte_per_var =
+            endian::native == endian::little &&
+            all_of(ranges.begin(), ranges.end(), [](int range) {
+                       return get_bit_size_for_range(range) <= 8;
+                   });
+    } else {
+        pack_bins(ranges);
+    }
+    compute_bin_fields(ranges);
 }
 
 IntPacker::~IntPacker() {
@@ -86,6 +111,92 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+void IntPacker::unpack_all(const Bin *buffer, int *values) const {
+    if (uses_one_byte_per_var) {
+        // Compilers turn this loop into SIMD zero-extensions.
+        const unsigned char *bytes =
+            reinterpret_cast<const unsigned char *>(buffer);
+        int num_vars = var_infos.size();
+        for (int var = 0; var < num_vars; ++var) {
+            values[var] = bytes[var];
+        }
+        return;
+    }
+    for (int bin = 0; bin < num_bins; ++bin) {
+        Bin value = buffer[bin];
+        for (int i = bin_begin[bin]; i < bin_begin[bin + 1]; ++i) {
+            const BinField &field = bin_fields[i];
+            values[field.var] = (value >> field.shift) & field.mask;
+        }
+    }
+}
+
+void IntPacker::pack_all(const int *values, Bin *buffer) const {
+    if (uses_one_byte_per_var) {
+        unsigned char *bytes = reinterpret_cast<unsigned char *>(buffer);
+        int num_vars = var_infos.size();
+        for (int var = 0; var < num_vars; ++var) {
+            assert(values[var] >= 0 && values[var] < 256);
+            bytes[var] = static_cast<unsigned char>(values[var]);
+        }
+        fill(bytes + num_vars, bytes + num_bins * sizeof(Bin), 0);
+        return;
+    }
+    for (int bin = 0; bin < num_bins; ++bin) {
+        Bin value = 0;
+        for (int i = bin_begin[bin]; i < bin_begin[bin + 1]; ++i) {
+            const BinField &field = bin_fields[i];
+            assert(values[field.var] >= 0 &&
+                   static_cast<Bin>(values[field.var]) <= field.mask);
+            value |= static_cast<Bin>(values[field.var]) << field.shift;
+        }
+        buffer[bin] = value;
+    }
+}
+
+void IntPacker::compute_bin_fields(const vector<int> &ranges) {
+    // Group the fields by bin (and by variable within each bin).
+    int num_vars = ranges.size();
+    bin_begin.assign(num_bins + 1, 0);
+    for (const VariableInfo &var_info : var_infos) {
+        ++bin_begin[var_info.get_bin_index() + 1];
+    }
+    for (int bin = 0; bin < num_bins; ++bin) {
+        bin_begin[bin + 1] += bin_begin[bin];
+    }
+    vector<int> next_field = bin_begin;
+    bin_fields.resize(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        const VariableInfo &var_info = var_infos[var];
+        bin_fields[next_field[var_info.get_bin_index()]++] =
+            {var, var_info.get_shift(), var_info.get_unshifted_mask()};
+    }
+}
+
+void IntPacker::pack_bins_byte_aligned(const vector<int> &ranges) {
+    assert(var_infos.empty());
+
+    int num_vars = ranges.size();
+    var_infos.resize(num_vars);
+
+    // Start a new bin for the first variable.
+    int used_bits = BITS_PER_BIN;
+    for (int var = 0; var < num_vars; ++var) {
+        int bits = 8;
+        while (bits < get_bit_size_for_range(ranges[var]))
+            bits *= 2;
+        assert(bits <= BITS_PER_BIN);
+        // Align the variable to a multiple of its size.
+        used_bits = (used_bits + bits - 1) / bits * bits;
+        if (used_bits + bits > BITS_PER_BIN) {
+            ++num_bins;
+            used_bits = 0;
+        }
+        var_infos[var] = VariableInfo(ranges[var], num_bins - 1, used_bits);
+        used_bits += bits;
+    }
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
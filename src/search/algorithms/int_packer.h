@@ -16,19 +16,49 @@
   Uses a greedy bin-packing strategy to pack the variables, which
   should be close to optimal in most cases. (See code comments for
   details.)
+
+  In byte-aligned mode, each variable instead takes up 1, 2 or 4 whole
+  bytes and the variables are laid out in index order. This uses more
+  memory, but if all variables fit into a byte, the bins are simply an
+  array of bytes and unpack_all and pack_all reduce to (vectorizable)
+  widening and narrowing copies.
 */
 namespace int_packer {
 class IntPacker {
+public:
+    typedef unsigned int Bin;
+private:
     class VariableInfo;
 
+    // Position of a variable within its bin, for bulk packing and unpacking.
+    struct BinField {
+        int var;
+        int shift;
+        // Mask of the variable's bits after shifting them to the right.
+        Bin mask;
+    };
+
     std::vector<VariableInfo> var_infos;
     int num_bins;
+    /*
+      The fields of bin b are bin_fields[bin_begin[b]] up to (excluding)
+      bin_fields[bin_begin[b + 1]].
+    */
+    std::vector<BinField> bin_fields;
+    std::vector<int> bin_begin;
+    /*
+      True if the bytes of the bins hold the values of the variables in
+      index order, i.e., all variables are byte-aligned, fit into a byte and
+      the platform is little-endian.
+    */
+    bool uses_one_byte_per_var;
 
     int pack_one_bin(const std::vector<int> &ranges,
                      std::vector<std::vector<int>> &bits_to_vars);
     void pack_bins(const std::vector<int> &ranges);
+    void pack_bins_byte_aligned(const std::vector<int> &ranges);
+    void compute_bin_fields(const std::vector<int> &ranges);
 public:
-    typedef unsigned int Bin;
 
     /*
       The constructor takes the range for each variable. The domain of
@@ -36,12 +66,25 @@ public:
       ints for the ranges (and genenerally for the values of variables),
       a variable can take up at most 31 bits if int is 32-bit.
     */
-    explicit IntPacker(const std::vector<int> &ranges);
+    explicit IntPacker(
+        const std::vector<int> &ranges, bool byte_aligned = false);
     ~IntPacker();
 
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Write the values of all variables to values[0], ..., values[n - 1]
+      for n variables. Reads every bin only once, which is considerably
+      faster than calling get for every variable.
+    */
+    void unpack_all(const Bin *buffer, int *values) const;
+    /*
+      Overwrite all bins of the buffer with the given values of all
+      variables. Unused bits are set to 0.
+    */
+    void pack_all(const int *values, Bin *buffer) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
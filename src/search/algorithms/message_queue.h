@@ -0,0 +1,71 @@
+#ifndef ALGORITHMS_MESSAGE_QUEUE_H
+#define ALGORITHMS_MESSAGE_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace message_queue {
+/*
+  Lock-free queue with many producers and a single consumer.
+
+  Producers push items onto a linked list with a compare-and-swap on its
+  head. The consumer takes all pending items at once by exchanging the head
+  with nullptr, so nodes are never removed while producers access them and
+  the ABA problem cannot occur. Items of the same producer are received in
+  the order in which they were pushed.
+*/
+template<typename T>
+class MessageQueue {
+    struct Node {
+        T item;
+        Node *next;
+    };
+
+    std::atomic<Node *> head;
+
+public:
+    MessageQueue() : head(nullptr) {
+    }
+
+    MessageQueue(const MessageQueue &) = delete;
+    MessageQueue &operator=(const MessageQueue &) = delete;
+
+    ~MessageQueue() {
+        Node *node = head.load();
+        while (node) {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void push(T &&item) {
+        Node *node = new Node {std::move(item), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(
+                   node->next, node,
+                   std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+
+    // Move all pending items to the end of items. Must only be called by the consumer.
+    void pop_all(std::vector<T> &items) {
+        Node *node = head.exchange(nullptr, std::memory_order_acquire);
+        std::size_t first = items.size();
+        while (node) {
+            items.push_back(std::move(node->item));
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        std::reverse(items.begin() + first, items.end());
+    }
+};
+}
+
+#endif
@@ -2,8 +2,12 @@
 #define ALGORITHMS_SEGMENTED_VECTOR_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 /*
@@ -35,6 +39,9 @@
   storing many fixed-size arrays. It's essentially a variant of SegmentedVector
   where the size of the stored data is only known at runtime, not at compile
   time. Note that we do not support 0-length arrays (checked with an assertion).
+
+  ConcurrentSegmentedArrayVector is a variant of SegmentedArrayVector that
+  supports concurrent push_back and lookup calls (but no pop_back).
 */
 
 /*
@@ -198,6 +205,15 @@ public:
           the_size(0) {
     }
 
+    /*
+      Replaces the allocator. This is only possible as long as no memory has
+      been allocated.
+    */
+    void set_allocator(const ElementAllocator &allocator_) {
+        assert(segments.empty());
+        element_allocator = allocator_;
+    }
+
     ~SegmentedArrayVector() {
         for (size_t i = 0; i < the_size; ++i) {
             for (size_t offset = 0; offset < elements_per_array; ++offset) {
@@ -262,6 +278,112 @@ public:
         }
     }
 };
+
+/*
+  Segment k of a ConcurrentSegmentedArrayVector holds 2^k times as many arrays
+  as the first segment. This way, a fixed number of segments suffices and the
+  segment table never has to be reallocated, so looking up an array never
+  races with adding a segment. The price is that up to half of the allocated
+  memory can be unused.
+
+  push_back reserves the index of the new array atomically and returns it. The
+  array can be looked up by any thread that learns this index through proper
+  synchronization (e.g., from a data structure protected by a mutex that the
+  pushing thread held while publishing the index). Arrays never move in
+  memory.
+*/
+template<class Element>
+class ConcurrentSegmentedArrayVector {
+    static const size_t FIRST_SEGMENT_BYTES = 8192;
+    static const int MAX_SEGMENTS = 48;
+
+    const size_t elements_per_array;
+    // The first segment holds 2^log_arrays_in_first_segment arrays.
+    const int log_arrays_in_first_segment;
+
+    std::array<std::atomic<Element *>, MAX_SEGMENTS> segments;
+    std::atomic<size_t> the_size;
+    std::mutex segment_mutex;
+
+    int get_segment(size_t index) const {
+        return std::bit_width((index >> log_arrays_in_first_segment) + 1) - 1;
+    }
+
+    size_t get_segment_begin(int segment) const {
+        return ((size_t(1) << segment) - 1) << log_arrays_in_first_segment;
+    }
+
+    size_t get_elements_per_segment(int segment) const {
+        return (elements_per_array << log_arrays_in_first_segment) << segment;
+    }
+
+    Element *get_array(size_t index) const {
+        int segment = get_segment(index);
+        size_t offset = (index - get_segment_begin(segment)) * elements_per_array;
+        return segments[segment].load(std::memory_order_acquire) + offset;
+    }
+
+    Element *get_or_add_segment(int segment) {
+        Element *result = segments[segment].load(std::memory_order_acquire);
+        if (!result) {
+            std::lock_guard<std::mutex> lock(segment_mutex);
+            result = segments[segment].load(std::memory_order_relaxed);
+            if (!result) {
+                result = new Element[get_elements_per_segment(segment)];
+                segments[segment].store(result, std::memory_order_release);
+            }
+        }
+        return result;
+    }
+
+    ConcurrentSegmentedArrayVector(const ConcurrentSegmentedArrayVector<Element> &) = delete;
+    ConcurrentSegmentedArrayVector &operator=(const ConcurrentSegmentedArrayVector<Element> &) = delete;
+public:
+    explicit ConcurrentSegmentedArrayVector(size_t elements_per_array_)
+        : elements_per_array((assert(elements_per_array_ > 0),
+                              elements_per_array_)),
+          log_arrays_in_first_segment(
+              std::bit_width(std::max(FIRST_SEGMENT_BYTES / (elements_per_array * sizeof(Element)), size_t(1))) - 1),
+          the_size(0) {
+        for (std::atomic<Element *> &segment : segments) {
+            segment.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentSegmentedArrayVector() {
+        for (std::atomic<Element *> &segment : segments) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    Element *operator[](size_t index) {
+        assert(index < size());
+        return get_array(index);
+    }
+
+    const Element *operator[](size_t index) const {
+        assert(index < size());
+        return get_array(index);
+    }
+
+    /*
+      Return the number of reserved indices. Arrays that are being pushed by
+      other threads are included, even if their data is not written yet.
+    */
+    size_t size() const {
+        return the_size.load(std::memory_order_acquire);
+    }
+
+    size_t push_back(const Element *entry) {
+        size_t index = the_size.fetch_add(1, std::memory_order_acq_rel);
+        int segment = get_segment(index);
+        assert(segment < MAX_SEGMENTS);
+        Element *dest = get_or_add_segment(segment) +
+            (index - get_segment_begin(segment)) * elements_per_array;
+        std::copy(entry, entry + elements_per_array, dest);
+        return index;
+    }
+};
 }
 
 #endif
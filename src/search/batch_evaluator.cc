@@ -0,0 +1,73 @@
+#include "batch_evaluator.h"
+
+#include "heuristic.h"
+#include "search_statistics.h"
+
+#include "utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <set>
+
+using namespace std;
+
+BatchEvaluator::BatchEvaluator(
+    const vector<vector<shared_ptr<Evaluator>>> &evaluator_instances)
+    : thread_pool(evaluator_instances.empty() ? 1 : evaluator_instances[0].size()) {
+    for (const vector<shared_ptr<Evaluator>> &instances : evaluator_instances) {
+        assert(static_cast<int>(instances.size()) == get_num_threads());
+        vector<shared_ptr<Heuristic>> heuristic_instances;
+        for (const shared_ptr<Evaluator> &evaluator : instances) {
+            shared_ptr<Heuristic> heuristic = dynamic_pointer_cast<Heuristic>(evaluator);
+            if (!heuristic || !heuristic->does_cache_estimates()) {
+                cerr << "Parallel evaluation is only supported for heuristics "
+                     << "that cache their estimates." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+            set<Evaluator *> path_dependent_evaluators;
+            heuristic->get_path_dependent_evaluators(path_dependent_evaluators);
+            if (!path_dependent_evaluators.empty()) {
+                cerr << "Parallel evaluation does not support path-dependent "
+                     << "heuristics." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+            }
+            if (find(heuristic_instances.begin(), heuristic_instances.end(),
+                     heuristic) != heuristic_instances.end()) {
+                cerr << "Parallel evaluation needs a separate heuristic "
+                     << "instance for every thread." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+            heuristic_instances.push_back(heuristic);
+        }
+        heuristics.push_back(move(heuristic_instances));
+    }
+}
+
+void BatchEvaluator::evaluate(vector<State> &states, SearchStatistics &statistics) {
+    int num_heuristics = heuristics.size();
+    estimates.resize(states.size() * num_heuristics);
+    thread_pool.run(
+        states.size(),
+        [&](int thread, int state_index) {
+            /*
+              Each state is processed by exactly one thread, which may
+              unpack it.
+            */
+            State &state = states[state_index];
+            for (int i = 0; i < num_heuristics; ++i) {
+                estimates[state_index * num_heuristics + i] =
+                    heuristics[i][thread]->compute_uncached_estimate(state);
+            }
+        });
+    for (size_t state_index = 0; state_index < states.size(); ++state_index) {
+        for (int i = 0; i < num_heuristics; ++i) {
+            Heuristic &heuristic = *heuristics[i][0];
+            heuristic.cache_estimate(
+                states[state_index], estimates[state_index * num_heuristics + i]);
+            if (heuristic.is_used_for_counting_evaluations()) {
+                statistics.inc_evaluations();
+            }
+        }
+    }
+}
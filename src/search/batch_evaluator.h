@@ -0,0 +1,53 @@
+#ifndef BATCH_EVALUATOR_H
+#define BATCH_EVALUATOR_H
+
+#include "utils/parallel.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+class Heuristic;
+class SearchStatistics;
+class State;
+
+/*
+  Computes the estimates of some heuristics for a batch of states with a
+  pool of threads. Every thread uses its own instance of each heuristic, so
+  the mutable data of the heuristics is never shared between threads. The
+  first instance of each heuristic is the one that the search uses. The
+  calling thread evaluates with it and the estimates computed by all
+  threads end up in its cache, so that evaluating the batch states with
+  this instance afterwards only looks up the cache.
+
+  The estimates do not depend on which thread computes them, so the search
+  behaves exactly as with sequential evaluation.
+*/
+class BatchEvaluator {
+    // heuristics[i][thread] is the instance of heuristic i used by thread.
+    std::vector<std::vector<std::shared_ptr<Heuristic>>> heuristics;
+    utils::ThreadPool thread_pool;
+    // The estimate of heuristic i for state j is estimates[j * #heuristics + i].
+    std::vector<int> estimates;
+public:
+    /*
+      evaluator_instances[i] contains one instance of evaluator i per
+      thread. All evaluators must be heuristics that cache their estimates
+      and are not path-dependent.
+    */
+    explicit BatchEvaluator(
+        const std::vector<std::vector<std::shared_ptr<Evaluator>>> &evaluator_instances);
+
+    int get_num_threads() const {
+        return thread_pool.get_num_threads();
+    }
+
+    /*
+      Compute and cache the estimates of all heuristics for the given states.
+      Each evaluation is counted in the statistics like an evaluation by the
+      search. The states must be distinct.
+    */
+    void evaluate(std::vector<State> &states, SearchStatistics &statistics);
+};
+
+#endif
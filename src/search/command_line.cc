@@ -8,6 +8,8 @@
 #include "plugins/any.h"
 #include "plugins/doc_printer.h"
 #include "plugins/plugin.h"
+#include "task_utils/task_properties.h"
+#include "utils/disk_cache.h"
 #include "utils/logging.h"
 #include "utils/strings.h"
 
@@ -178,6 +180,19 @@ shared_ptr<SearchAlgorithm> parse_cmd_line(
             active = !is_unit_cost;
         } else if (arg == "--always") {
             active = true;
+        } else if (arg == "--byte-aligned-states") {
+            /*
+              The state packers are created while constructing the search
+              algorithm, so this option has to be handled before --search.
+            */
+            if (active)
+                task_properties::g_use_byte_aligned_state_packing = true;
+        } else if (arg == "--cache-directory") {
+            if (i == argc - 1)
+                input_error("missing argument after --cache-directory");
+            string directory = argv[++i];
+            if (active)
+                utils::set_cache_directory(directory);
         } else if (active) {
             args.push_back(arg);
         }
@@ -196,6 +211,12 @@ string usage(const string &progname) {
            "--help [NAME]\n"
            "    Prints help for all heuristics, open lists, etc. called NAME.\n"
            "    Without parameter: prints help for everything available\n"
+           "--byte-aligned-states\n"
+           "    Store every state variable in 1, 2 or 4 whole bytes. Uses more\n"
+           "    memory per state, but packs and unpacks states faster.\n\n"
+           "--cache-directory DIR\n"
+           "    Store PDBs in DIR and reuse them in later runs on tasks with the\n"
+           "    same variables, operators and goals (Linux and macOS only).\n\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
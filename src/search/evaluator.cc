@@ -5,9 +5,53 @@
 #include "utils/system.h"
 
 #include <cassert>
+#include <functional>
+#include <mutex>
+#include <queue>
 
 using namespace std;
 
+namespace {
+class CacheSlotAllocator {
+    mutex slots_mutex;
+    int num_slots = 0;
+    // Released slots, the smallest one is reused first.
+    priority_queue<int, vector<int>, greater<int>> free_slots;
+public:
+    int allocate() {
+        lock_guard<mutex> lock(slots_mutex);
+        if (free_slots.empty()) {
+            return num_slots++;
+        }
+        int slot = free_slots.top();
+        free_slots.pop();
+        return slot;
+    }
+
+    void release(int slot) {
+        lock_guard<mutex> lock(slots_mutex);
+        free_slots.push(slot);
+    }
+};
+
+/*
+  The allocator is never destroyed, because evaluators that are destroyed
+  during static destruction still release their slots.
+*/
+CacheSlotAllocator &get_cache_slot_allocator() {
+    static CacheSlotAllocator *allocator = new CacheSlotAllocator();
+    return *allocator;
+}
+}
+
+static shared_ptr<const int> allocate_cache_slot() {
+    return shared_ptr<const int>(
+        new int(get_cache_slot_allocator().allocate()),
+        [](const int *slot) {
+            get_cache_slot_allocator().release(*slot);
+            delete slot;
+        });
+}
 
 Evaluator::Evaluator(
     bool use_for_reporting_minima, bool use_for_boosting,
@@ -17,13 +61,24 @@ Evaluator::Evaluator(
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations),
+      cache_slot_owner(allocate_cache_slot()),
+      cache_slot(*cache_slot_owner),
       log(utils::get_log_for_verbosity(verbosity)) {
 }
 
+void Evaluator::share_cache_slots(const Evaluator &other) {
+    cache_slot_owner = other.cache_slot_owner;
+    cache_slot = other.cache_slot;
+}
+
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+shared_ptr<Evaluator> Evaluator::clone_for_worker() const {
+    return nullptr;
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result) const {
     if (log.is_at_least_normal()) {
@@ -5,6 +5,7 @@
 
 #include "utils/logging.h"
 
+#include <memory>
 #include <set>
 
 class EvaluationContext;
@@ -19,6 +20,17 @@ class Evaluator {
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+    /*
+      Dense index assigned at construction, which determines where
+      EvaluatorCache stores the results of this evaluator. Copies (see
+      clone_for_worker) keep the slot of the original, since they are
+      never used in the same evaluation context as the original. A slot is
+      reused by new evaluators once all evaluators holding it are
+      destroyed, so the evaluators of a search get small slots even if
+      earlier searches or worker threads created many evaluators.
+    */
+    std::shared_ptr<const int> cache_slot_owner;
+    int cache_slot;
 protected:
     mutable utils::LogProxy log;
 public:
@@ -28,6 +40,18 @@ public:
         const std::string &description, utils::Verbosity verbosity);
     virtual ~Evaluator() = default;
 
+    int get_cache_slot() const {
+        return cache_slot;
+    }
+
+    /*
+      Use the cache slot of other (and the slots of corresponding
+      subevaluators). This is only allowed if this evaluator and other are
+      never used in the same evaluation context, e.g., because they belong
+      to different worker threads.
+    */
+    virtual void share_cache_slots(const Evaluator &other);
+
     /*
       dead_ends_are_reliable should return true if the evaluator is
       "safe", i.e., infinite estimates can be trusted.
@@ -82,6 +106,18 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      clone_for_worker should return a new instance of this evaluator that
+      another thread can use concurrently with this one, or nullptr if the
+      evaluator does not support this. The new instance should share all
+      data that does not change after construction (e.g., precomputed
+      tables) and only duplicate the data that is modified during
+      evaluation. Cached estimates are not copied.
+
+      The default implementation returns nullptr.
+    */
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const;
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
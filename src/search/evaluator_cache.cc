@@ -1,8 +1,25 @@
 #include "evaluator_cache.h"
 
+#include "evaluator.h"
+
+#include <cassert>
+
 using namespace std;
 
 
+EvaluatorCache::Entry &EvaluatorCache::get_overflow_entry(int slot) {
+    size_t index = slot - NUM_INLINE_SLOTS;
+    if (index >= overflow_entries.size()) {
+        overflow_entries.resize(index + 1);
+    }
+    return overflow_entries[index];
+}
+
 EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
-    return eval_results[eval];
+    int slot = eval->get_cache_slot();
+    Entry &entry = slot < NUM_INLINE_SLOTS ?
+        inline_entries[slot] : get_overflow_entry(slot);
+    assert(!entry.evaluator || entry.evaluator == eval);
+    entry.evaluator = eval;
+    return entry.result;
 }
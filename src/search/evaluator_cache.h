@@ -3,27 +3,46 @@
 
 #include "evaluation_result.h"
 
-#include <unordered_map>
+#include <array>
+#include <vector>
 
 class Evaluator;
 
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
-
 /*
   Store evaluation results for evaluators.
+
+  The results are stored at the cache slot of each evaluator (see
+  Evaluator::get_cache_slot). The first slots are stored inline, so that
+  creating a cache and accessing results of the evaluators of a typical
+  search involves no hashing and no memory allocation.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+    static const int NUM_INLINE_SLOTS = 8;
+
+    struct Entry {
+        const Evaluator *evaluator = nullptr;
+        EvaluationResult result;
+    };
 
+    std::array<Entry, NUM_INLINE_SLOTS> inline_entries;
+    // Entries for slots from NUM_INLINE_SLOTS onwards.
+    std::vector<Entry> overflow_entries;
+
+    Entry &get_overflow_entry(int slot);
 public:
     EvaluationResult &operator[](Evaluator *eval);
 
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
-            const Evaluator *eval = element.first;
-            const EvaluationResult &result = element.second;
-            callback(eval, result);
+        for (const Entry &entry : inline_entries) {
+            if (entry.evaluator) {
+                callback(entry.evaluator, entry.result);
+            }
+        }
+        for (const Entry &entry : overflow_entries) {
+            if (entry.evaluator) {
+                callback(entry.evaluator, entry.result);
+            }
         }
     }
 };
@@ -19,10 +19,35 @@ CombiningEvaluator::CombiningEvaluator(
             all_dead_ends_are_reliable = false;
 }
 
+bool CombiningEvaluator::clone_subevaluators() {
+    for (shared_ptr<Evaluator> &subevaluator : subevaluators) {
+        subevaluator = subevaluator->clone_for_worker();
+        if (!subevaluator) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool CombiningEvaluator::dead_ends_are_reliable() const {
     return all_dead_ends_are_reliable;
 }
 
+void CombiningEvaluator::share_cache_slots(const Evaluator &other) {
+    Evaluator::share_cache_slots(other);
+    const CombiningEvaluator *other_combining =
+        dynamic_cast<const CombiningEvaluator *>(&other);
+    if (other_combining &&
+        other_combining->subevaluators.size() == subevaluators.size()) {
+        for (size_t i = 0; i < subevaluators.size(); ++i) {
+            if (subevaluators[i] != other_combining->subevaluators[i]) {
+                subevaluators[i]->share_cache_slots(
+                    *other_combining->subevaluators[i]);
+            }
+        }
+    }
+}
+
 EvaluationResult CombiningEvaluator::compute_result(
     EvaluationContext &eval_context) {
     // This marks no preferred operators.
@@ -18,6 +18,13 @@ class CombiningEvaluator : public Evaluator {
     bool all_dead_ends_are_reliable;
 protected:
     virtual int combine_values(const std::vector<int> &values) = 0;
+
+    /*
+      Replaces all subevaluators by clones for another worker (see
+      Evaluator::clone_for_worker). Returns false if a subevaluator does not
+      support cloning. Used for implementing clone_for_worker on a copy.
+    */
+    bool clone_subevaluators();
 public:
     CombiningEvaluator(
         const std::vector<std::shared_ptr<Evaluator>> &evals,
@@ -37,6 +44,7 @@ public:
     */
 
     virtual bool dead_ends_are_reliable() const override;
+    virtual void share_cache_slots(const Evaluator &other) override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
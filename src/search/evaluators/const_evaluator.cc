@@ -11,6 +11,10 @@ ConstEvaluator::ConstEvaluator(
       value(value) {
 }
 
+shared_ptr<Evaluator> ConstEvaluator::clone_for_worker() const {
+    return make_shared<ConstEvaluator>(*this);
+}
+
 EvaluationResult ConstEvaluator::compute_result(EvaluationContext &) {
     EvaluationResult result;
     result.set_evaluator_value(value);
@@ -22,6 +22,7 @@ public:
         utils::Verbosity verbosity);
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &) override {}
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
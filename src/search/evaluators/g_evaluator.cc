@@ -12,6 +12,10 @@ GEvaluator::GEvaluator(const string &description,
     : Evaluator(false, false, false, description, verbosity) {
 }
 
+shared_ptr<Evaluator> GEvaluator::clone_for_worker() const {
+    return make_shared<GEvaluator>(*this);
+}
+
 
 EvaluationResult GEvaluator::compute_result(EvaluationContext &eval_context) {
     EvaluationResult result;
@@ -13,6 +13,14 @@ MaxEvaluator::MaxEvaluator(
     : CombiningEvaluator(evals, description, verbosity) {
 }
 
+shared_ptr<Evaluator> MaxEvaluator::clone_for_worker() const {
+    shared_ptr<MaxEvaluator> clone = make_shared<MaxEvaluator>(*this);
+    if (!clone->clone_subevaluators()) {
+        return nullptr;
+    }
+    return clone;
+}
+
 int MaxEvaluator::combine_values(const vector<int> &values) {
     int result = 0;
     for (int value : values) {
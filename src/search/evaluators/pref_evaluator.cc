@@ -12,6 +12,10 @@ PrefEvaluator::PrefEvaluator(
     : Evaluator(false, false, false, description, verbosity) {
 }
 
+shared_ptr<Evaluator> PrefEvaluator::clone_for_worker() const {
+    return make_shared<PrefEvaluator>(*this);
+}
+
 EvaluationResult PrefEvaluator::compute_result(
     EvaluationContext &eval_context) {
     EvaluationResult result;
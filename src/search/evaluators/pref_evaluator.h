@@ -15,6 +15,7 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
     virtual void get_path_dependent_evaluators(std::set<Evaluator *> &) override {}
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
@@ -13,6 +13,14 @@ SumEvaluator::SumEvaluator(
     : CombiningEvaluator(evals, description, verbosity) {
 }
 
+shared_ptr<Evaluator> SumEvaluator::clone_for_worker() const {
+    shared_ptr<SumEvaluator> clone = make_shared<SumEvaluator>(*this);
+    if (!clone->clone_subevaluators()) {
+        return nullptr;
+    }
+    return clone;
+}
+
 int SumEvaluator::combine_values(const vector<int> &values) {
     int result = 0;
     for (int value : values) {
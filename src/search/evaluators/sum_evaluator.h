@@ -18,6 +18,8 @@ public:
     SumEvaluator(
         const std::vector<std::shared_ptr<Evaluator>> &evals,
         const std::string &description, utils::Verbosity verbosity);
+
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
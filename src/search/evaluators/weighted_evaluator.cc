@@ -40,6 +40,15 @@ void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+shared_ptr<Evaluator> WeightedEvaluator::clone_for_worker() const {
+    shared_ptr<WeightedEvaluator> clone = make_shared<WeightedEvaluator>(*this);
+    clone->evaluator = evaluator->clone_for_worker();
+    if (!clone->evaluator) {
+        return nullptr;
+    }
+    return clone;
+}
+
 class WeightedEvaluatorFeature
     : public plugins::TypedFeature<Evaluator, WeightedEvaluator> {
 public:
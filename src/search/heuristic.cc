@@ -24,6 +24,14 @@ Heuristic::Heuristic(
       task_proxy(*task) {
 }
 
+Heuristic::Heuristic(const Heuristic &other)
+    : Evaluator(other),
+      heuristic_cache(HEntry(NO_VALUE, true)),
+      cache_evaluator_values(other.cache_evaluator_values),
+      task(other.task),
+      task_proxy(*task) {
+}
+
 Heuristic::~Heuristic() {
 }
 
@@ -66,13 +74,16 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_evaluator_values &&
+    // Only registered states can be cached.
+    bool use_cache = cache_evaluator_values && state.get_registry();
+
+    if (!calculate_preferred && use_cache &&
         heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
         heuristic = heuristic_cache[state].h;
         result.set_count_evaluation(false);
     } else {
         heuristic = compute_heuristic(state);
-        if (cache_evaluator_values) {
+        if (use_cache) {
             heuristic_cache[state] = HEntry(heuristic, false);
         }
         result.set_count_evaluation(true);
@@ -108,6 +119,20 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+int Heuristic::compute_uncached_estimate(const State &ancestor_state) {
+    assert(preferred_operators.empty());
+    int estimate = compute_heuristic(ancestor_state);
+    preferred_operators.clear();
+    assert(estimate == DEAD_END || estimate >= 0);
+    return estimate;
+}
+
+void Heuristic::cache_estimate(const State &state, int estimate) {
+    assert(cache_evaluator_values);
+    assert(estimate == DEAD_END || estimate >= 0);
+    heuristic_cache[state] = HEntry(estimate, false);
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
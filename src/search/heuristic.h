@@ -72,6 +72,12 @@ protected:
 
     State convert_ancestor_state(const State &ancestor_state) const;
 
+    /*
+      Copy constructor for implementing clone_for_worker in derived
+      classes. The copy starts with an empty cache.
+    */
+    Heuristic(const Heuristic &other);
+
 public:
     Heuristic(
         const std::shared_ptr<AbstractTask> &transform,
@@ -86,6 +92,20 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
+    /*
+      Compute the estimate for the given state without accessing the cache
+      and without reporting preferred operators. Dead ends are reported as
+      DEAD_END. Since no per-state information is touched, distinct
+      instances of a heuristic can use this method concurrently for states
+      of the same registry (see BatchEvaluator).
+    */
+    int compute_uncached_estimate(const State &ancestor_state);
+    /*
+      Store an estimate computed by compute_uncached_estimate() (possibly of
+      another instance of the same heuristic) in the cache.
+    */
+    void cache_estimate(const State &state, int estimate);
+
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
     virtual int get_cached_estimate(const State &state) const override;
@@ -26,6 +26,15 @@ AdditiveHeuristic::AdditiveHeuristic(
     }
 }
 
+AdditiveHeuristic::AdditiveHeuristic(const AdditiveHeuristic &other)
+    : RelaxationHeuristic(other),
+      did_write_overflow_warning(other.did_write_overflow_warning) {
+}
+
+shared_ptr<Evaluator> AdditiveHeuristic::clone_for_worker() const {
+    return shared_ptr<Evaluator>(new AdditiveHeuristic(*this));
+}
+
 void AdditiveHeuristic::write_overflow_warning() {
     if (!did_write_overflow_warning) {
         // TODO: Should have a planner-wide warning mechanism to handle
@@ -80,7 +89,7 @@ void AdditiveHeuristic::relaxed_exploration() {
             continue;
         if (prop->is_goal && --unsolved_goals == 0)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
+        for (OpID op_id : precondition_of_pool->get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
             UnaryOperator *unary_op = get_operator(op_id);
             increase_cost(unary_op->cost, prop_cost);
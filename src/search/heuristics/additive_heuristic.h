@@ -64,6 +64,9 @@ protected:
 
     // Common part of h^add and h^ff computation.
     int compute_add_and_ff(const State &state);
+
+    // Copy constructor for clone_for_worker. The copy gets its own queue.
+    AdditiveHeuristic(const AdditiveHeuristic &other);
 public:
     AdditiveHeuristic(
         tasks::AxiomHandlingType axioms,
@@ -71,6 +74,8 @@ public:
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
 
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
+
     /*
       TODO: The two methods below are temporarily needed for the CEGAR
       heuristic. In the long run it might be better to split the
@@ -23,6 +23,10 @@ BlindSearchHeuristic::BlindSearchHeuristic(
     }
 }
 
+shared_ptr<Evaluator> BlindSearchHeuristic::clone_for_worker() const {
+    return make_shared<BlindSearchHeuristic>(*this);
+}
+
 int BlindSearchHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     if (task_properties::is_goal_state(task_proxy, state))
@@ -18,7 +18,7 @@ DualHTwoHeuristic::DualHTwoHeuristic(
     const shared_ptr<AbstractTask> &transform,
     bool cache_estimates, const string &description,
     utils::Verbosity verbosity)
-    : HTwoHeuristic(transform, cache_estimates, description, verbosity) {
+    : HTwoHeuristic(false, transform, cache_estimates, description, verbosity) {
     // Create dual task
     dual_task = extra_tasks::build_dual_task(transform);
     log << "Initializied dual task" << endl;
@@ -34,28 +34,67 @@ DualHTwoHeuristic::DualHTwoHeuristic(
     HTwoHeuristic::compute_heuristic(State(*dual_task, std::move(values)));
     HTwoHeuristic::task_proxy = original_task_proxy;
     goals = original_goals;
+    init_dual_table();
+}
+
+/*
+ * Copy the values of all pairs of dual atoms (f, 1) from hm_table (computed on the dual task) into dual_table.
+ */
+void DualHTwoHeuristic::init_dual_table() {
+    num_original_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        original_fact_offsets.push_back(num_original_facts);
+        num_original_facts += var.get_domain_size();
+    }
+    // The dual task has one binary variable per fact of the original task, in the same order.
+    assert(num_facts == 2 * num_original_facts);
+    auto table = make_shared<vector<int>>(
+        static_cast<size_t>(num_original_facts) * (num_original_facts + 1) / 2);
+    for (int b = 0; b < num_original_facts; ++b) {
+        for (int a = 0; a <= b; ++a) {
+            (*table)[get_index(a, b)] = hm_table[get_index(2 * a + 1, 2 * b + 1)];
+        }
+    }
+    dual_table = move(table);
+    fact_masks.assign(num_original_facts, ~0);
+    vector<int>().swap(hm_table);
+}
+
+shared_ptr<Evaluator> DualHTwoHeuristic::clone_for_worker() const {
+    return make_shared<DualHTwoHeuristic>(*this);
 }
 
 
 /*
- * Convert states into STRIPS representation and negate all values. Look up with eval function on precomputed hm_table.
+ * Computes the maximum over all pairs of dual atoms that hold in the dual state, i.e., over all pairs of facts that are
+ * false in the state. Entries of state facts are masked to 0, which lets the compiler vectorize the row maxima.
  */
 int DualHTwoHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = Heuristic::convert_ancestor_state(ancestor_state);
-    vector<int> state_values = state.get_unpacked_values();
-    dynamic_pointer_cast<extra_tasks::DualTask>(dual_task)->convert_state_values_from_parent(state_values);
-	vector<FactPair> state_atoms = {};
-    for (size_t i = 0; i < state_values.size(); i++) {
-        if (state_values[i] == 1) {
-        	state_atoms.push_back(FactPair(i, state_values[i]));
+    for (FactProxy fact : state) {
+        fact_masks[original_fact_offsets[fact.get_variable().get_id()] + fact.get_value()] = 0;
+    }
+    const int *table = dual_table->data();
+    int h = 0;
+    for (int b = 0; b < num_original_facts && h != INT_MAX; ++b) {
+        if (!fact_masks[b]) {
+            continue;
         }
+        const int *row = table + get_index(0, b);
+        const int *masks = fact_masks.data();
+        int row_max = 0;
+        for (int a = 0; a <= b; ++a) {
+            row_max = max(row_max, row[a] & masks[a]);
+        }
+        h = max(h, row_max);
+    }
+    for (FactProxy fact : state) {
+        fact_masks[original_fact_offsets[fact.get_variable().get_id()] + fact.get_value()] = ~0;
     }
-    int h = eval(state_atoms);
     if (h == INT_MAX) {
         return DEAD_END;
     }
     return h;
-
 }
 
 
@@ -4,6 +4,7 @@
 #include "../heuristic.h"
 #include "../heuristics/htwo_heuristic.h"
 
+#include <memory>
 #include <unordered_map>
 
 
@@ -13,6 +14,17 @@ class Options;
 }
 
 namespace dual_htwo_heuristic {
+/*
+  The h^2 table of the dual task is computed once in the constructor. The
+  atoms of the dual task that can hold in a dual state are the atoms
+  (f, 1) for facts f of the original task, meaning that f is false. Their
+  pair values are stored in dual_table, a dense triangular table over the
+  global fact indices of the original task, and the h^2 table itself is
+  released.
+
+  A state is evaluated directly on its facts: the value is the maximum of
+  all rows and columns of dual_table that do not belong to state facts.
+*/
 class DualHTwoHeuristic : public htwo_heuristic::HTwoHeuristic {
 
 protected:
@@ -20,6 +32,20 @@ protected:
 
 	std::shared_ptr<AbstractTask> dual_task;
 
+    /*
+      Entry of the pair {a, b} (a <= b) at b * (b + 1) / 2 + a. Row b, i.e.,
+      all pairs {a, b} with a <= b, is contiguous. The table is shared by
+      all clones of the heuristic.
+    */
+    std::shared_ptr<const std::vector<int>> dual_table;
+    // Global index of fact (var, 0) of the original task for every variable.
+    std::vector<int> original_fact_offsets;
+    int num_original_facts;
+    // Bit mask per fact: 0 for the facts of the evaluated state, ~0 otherwise.
+    std::vector<int> fact_masks;
+
+    void init_dual_table();
+
 
 
 public:
@@ -30,6 +56,8 @@ public:
 
     int create_hm_table(std::vector<int> init_values);
 
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
+
 
 };
 }
@@ -24,6 +24,10 @@ FFHeuristic::FFHeuristic(
     }
 }
 
+shared_ptr<Evaluator> FFHeuristic::clone_for_worker() const {
+    return make_shared<FFHeuristic>(*this);
+}
+
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
     const State &state, PropID goal_id) {
     Proposition *goal = get_proposition(goal_id);
@@ -17,6 +17,10 @@ GoalCountHeuristic::GoalCountHeuristic(
     }
 }
 
+shared_ptr<Evaluator> GoalCountHeuristic::clone_for_worker() const {
+    return make_shared<GoalCountHeuristic>(*this);
+}
+
 int GoalCountHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int unsatisfied_goal_count = 0;
@@ -12,6 +12,8 @@ public:
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
+
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
@@ -0,0 +1,613 @@
+#include "hthree_heuristic.h"
+
+#include "../plugins/plugin.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+using namespace std;
+
+namespace hthree_heuristic {
+HThreeHeuristic::HThreeHeuristic(
+    int max_table_memory,
+    const shared_ptr<AbstractTask> &transform,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
+    : Heuristic(transform, cache_estimates, description, verbosity),
+      has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
+      max_table_memory(max_table_memory),
+      num_instances(make_shared<int>(1)),
+      epoch(0),
+      op_stamp(0),
+      fact_stamp(0) {
+    if (log.is_at_least_normal()) {
+        log << "Initializing h^3" << endl;
+    }
+    init_operator_caches();
+
+    const size_t num_entries = num_table_entries(num_facts);
+    const double table_memory_in_mb = static_cast<double>(num_entries) * sizeof(int) / (1024 * 1024);
+    /*
+      Every operator and the list that is processed (see
+      process_changed_extensions) can hold one buffer.
+    */
+    const double extensions_memory_in_mb =
+        static_cast<double>(precondition_cache.size() + 1) * max_changed_extensions *
+        sizeof(pair<int, int>) / (1024 * 1024);
+    memory_in_mb = table_memory_in_mb + extensions_memory_in_mb;
+    if (log.is_at_least_normal()) {
+        log << "h^3 table entries: " << num_entries << " ("
+            << table_memory_in_mb << " MB)" << endl;
+        log << "h^3 changed extension lists: at most "
+            << extensions_memory_in_mb << " MB" << endl;
+    }
+    if (memory_in_mb > max_table_memory) {
+        log << "h^3 exceeds the memory limit of "
+            << max_table_memory << " MB" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    hm_table.assign(num_entries, INT_MAX);
+}
+
+bool HThreeHeuristic::dead_ends_are_reliable() const {
+    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
+}
+
+shared_ptr<Evaluator> HThreeHeuristic::clone_for_worker() const {
+    /*
+      The table dominates the memory usage, so we simply copy everything
+      instead of sharing the operator caches. All copies count against the
+      memory limit.
+    */
+    if ((*num_instances + 1) * memory_in_mb > max_table_memory) {
+        log << "h^3 with " << *num_instances + 1 << " threads exceeds the "
+            << "memory limit of " << max_table_memory << " MB" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    ++*num_instances;
+    return make_shared<HThreeHeuristic>(*this);
+}
+
+size_t HThreeHeuristic::num_table_entries(int num_facts) {
+    const size_t n = num_facts;
+    return n + n * (n - 1) / 2 + n * (n - 1) * (n - 2) / 6;
+}
+
+size_t HThreeHeuristic::rank(int a, int b) const {
+    assert(a != b);
+    if (a > b) {
+        swap(a, b);
+    }
+    const size_t b_ = b;
+    return pair_offset + b_ * (b_ - 1) / 2 + a;
+}
+
+size_t HThreeHeuristic::rank(int a, int b, int c) const {
+    if (a > b) {
+        swap(a, b);
+    }
+    if (b > c) {
+        swap(b, c);
+    }
+    if (a > b) {
+        swap(a, b);
+    }
+    assert(a < b && b < c);
+    const size_t b_ = b;
+    const size_t c_ = c;
+    return triple_offset + c_ * (c_ - 1) * (c_ - 2) / 6 + b_ * (b_ - 1) / 2 + a;
+}
+
+int HThreeHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        return 0;
+    }
+    state_facts.clear();
+    for (FactProxy fact : state) {
+        state_facts.push_back(get_fact_index(fact.get_pair()));
+    }
+    init_hm_table();
+    init_operator_queue();
+    update_hm_table();
+    int h = eval(goal_facts);
+    if (h == INT_MAX) {
+        return DEAD_END;
+    }
+    return h;
+}
+
+/*
+ * Sets up the fact indices and all operator data. These do not change throughout the search.
+ */
+void HThreeHeuristic::init_operator_caches() {
+    num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            fact_vars.push_back(var.get_id());
+        }
+    }
+    pair_offset = num_facts;
+    triple_offset = pair_offset + static_cast<size_t>(num_facts) * (num_facts - 1) / 2;
+
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goal_facts.push_back(get_fact_index(goal.get_pair()));
+    }
+    sort(goal_facts.begin(), goal_facts.end());
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    const int num_operators = operators.size();
+    vector<int> empty_pre_ops;
+    effect_var_cache.assign(num_operators, vector<bool>(task_proxy.get_variables().size(), false));
+    for (OperatorProxy op : operators) {
+        vector<int> pre;
+        for (FactProxy fact : op.get_preconditions()) {
+            pre.push_back(get_fact_index(fact.get_pair()));
+        }
+        sort(pre.begin(), pre.end());
+        if (pre.empty()) {
+            empty_pre_ops.push_back(op.get_id());
+        }
+        precondition_cache.push_back(move(pre));
+
+        vector<int> eff;
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            eff.push_back(get_fact_index(fact));
+            effect_var_cache[op.get_id()][fact.var] = true;
+        }
+        sort(eff.begin(), eff.end());
+        effect_cache.push_back(move(eff));
+        op_base_cost.push_back(op.get_cost());
+    }
+    op_dict.assign(num_facts, empty_pre_ops);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        for (int fact : precondition_cache[op_id]) {
+            op_dict[fact].push_back(op_id);
+        }
+    }
+
+    op_queue.init(num_operators);
+    op_cost.assign(num_operators, INT_MAX);
+    changed_extensions.assign(num_operators, {});
+    changed_extensions_epoch.assign(num_operators, 0);
+    changed_extensions_overflow.assign(num_operators, false);
+    /*
+      Processing more than num_facts changed extensions costs about as much
+      as processing the whole operator.
+    */
+    max_changed_extensions = max(num_facts, 1);
+    op_stamps.assign(num_operators, 0);
+    extension_costs.assign(num_facts, INT_MAX);
+    fact_stamps.assign(num_facts, 0);
+}
+
+/*
+ * All subsets of the state atoms get value 0, all other entries infinity.
+ */
+void HThreeHeuristic::init_hm_table() {
+    fill(hm_table.begin(), hm_table.end(), INT_MAX);
+    const size_t n = state_facts.size();
+    for (size_t i = 0; i < n; ++i) {
+        const int a = state_facts[i];
+        hm_table[rank(a)] = 0;
+        for (size_t j = i + 1; j < n; ++j) {
+            const int b = state_facts[j];
+            hm_table[rank(a, b)] = 0;
+            for (size_t k = j + 1; k < n; ++k) {
+                hm_table[rank(a, b, state_facts[k])] = 0;
+            }
+        }
+    }
+}
+
+/*
+ * Queues all operators that are applicable in the evaluated state.
+ */
+void HThreeHeuristic::init_operator_queue() {
+    fill(op_cost.begin(), op_cost.end(), INT_MAX);
+    // Invalidates all changed extensions of the last evaluation.
+    ++epoch;
+    for (size_t op_id = 0; op_id < precondition_cache.size(); ++op_id) {
+        bool applicable = true;
+        for (int fact : precondition_cache[op_id]) {
+            if (hm_table[rank(fact)] != 0) {
+                applicable = false;
+                break;
+            }
+        }
+        if (applicable) {
+            op_queue.push(op_id);
+        }
+    }
+}
+
+/*
+ * Processes operators until the queue is empty. An operator whose precondition value changed is processed
+ * completely, otherwise only its changed extensions are considered.
+ */
+void HThreeHeuristic::update_hm_table() {
+    while (!op_queue.empty()) {
+        const int op_id = op_queue.pop();
+        const int c1 = eval(precondition_cache[op_id]);
+        if (c1 == INT_MAX) {
+            continue;
+        }
+        get_changed_extensions(op_id);
+        if (c1 != op_cost[op_id] || changed_extensions_overflow[op_id]) {
+            op_cost[op_id] = c1;
+            reset_changed_extensions(op_id);
+            process_operator(op_id, c1);
+        } else {
+            process_changed_extensions(op_id, c1);
+        }
+    }
+}
+
+/*
+ * Updates all subsets of eff(op) and all their extensions by one or two atoms that are consistent with op.
+ */
+void HThreeHeuristic::process_operator(int op_id, int pre_cost) {
+    const vector<int> &eff = effect_cache[op_id];
+    const int cost = op_base_cost[op_id];
+    const int val = pre_cost + cost;
+    const size_t n = eff.size();
+    for (size_t i = 0; i < n; ++i) {
+        update_hm_entry(eff[i], val);
+        for (size_t j = i + 1; j < n; ++j) {
+            update_hm_entry(eff[i], eff[j], val);
+            for (size_t k = j + 1; k < n; ++k) {
+                update_hm_entry(eff[i], eff[j], eff[k], val);
+            }
+        }
+    }
+
+    compute_extension_costs(op_id, pre_cost);
+    for (int x = 0; x < num_facts; ++x) {
+        const int cost_x = extension_costs[x];
+        if (cost_x == INT_MAX) {
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            update_hm_entry(eff[i], x, cost_x + cost);
+            for (size_t j = i + 1; j < n; ++j) {
+                update_hm_entry(eff[i], eff[j], x, cost_x + cost);
+            }
+        }
+        extend_with_pairs(op_id, x, x + 1);
+    }
+}
+
+/*
+ * Handles the extensions of op that changed since op was processed last. The precondition value of op is unchanged.
+ */
+void HThreeHeuristic::process_changed_extensions(int op_id, int pre_cost) {
+    const vector<int> &eff = effect_cache[op_id];
+    const int cost = op_base_cost[op_id];
+    const size_t n = eff.size();
+    /*
+      Extensions that change while processing op are collected in the (then empty) list of op, which is queued
+      again by notify_operators.
+    */
+    processed_extensions.swap(get_changed_extensions(op_id));
+    bool extension_costs_computed = false;
+    ++fact_stamp;
+    for (const pair<int, int> &extension : processed_extensions) {
+        const int x = extension.first;
+        const int y = extension.second;
+        if (y == -1) {
+            if (fact_stamps[x] == fact_stamp) {
+                continue;
+            }
+            fact_stamps[x] = fact_stamp;
+            const int cost_x = extension_eval(op_id, x, pre_cost);
+            if (cost_x == INT_MAX) {
+                continue;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                update_hm_entry(eff[i], x, cost_x + cost);
+                for (size_t j = i + 1; j < n; ++j) {
+                    update_hm_entry(eff[i], eff[j], x, cost_x + cost);
+                }
+            }
+            if (!extension_costs_computed) {
+                compute_extension_costs(op_id, pre_cost);
+                extension_costs_computed = true;
+            }
+            extension_costs[x] = cost_x;
+            extend_with_pairs(op_id, x, 0);
+        } else {
+            if (fact_vars[x] == fact_vars[y]) {
+                continue;
+            }
+            const int cost_x = extension_eval(op_id, x, pre_cost);
+            const int cost_y = extension_eval(op_id, y, pre_cost);
+            if (cost_x == INT_MAX || cost_y == INT_MAX) {
+                continue;
+            }
+            const int c2 = extension_eval(op_id, x, y, cost_x, cost_y);
+            if (c2 == INT_MAX) {
+                continue;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                update_hm_entry(eff[i], x, y, c2 + cost);
+            }
+        }
+    }
+    processed_extensions.clear();
+}
+
+void HThreeHeuristic::compute_extension_costs(int op_id, int pre_cost) {
+    for (int x = 0; x < num_facts; ++x) {
+        extension_costs[x] = extension_eval(op_id, x, pre_cost);
+    }
+}
+
+/*
+ * Updates the entries {e, x, y} for all effects e and atoms y >= first_y. Requires valid extension_costs.
+ */
+void HThreeHeuristic::extend_with_pairs(int op_id, int x, int first_y) {
+    const vector<int> &eff = effect_cache[op_id];
+    const int cost = op_base_cost[op_id];
+    const int cost_x = extension_costs[x];
+    const int var_x = fact_vars[x];
+    for (int y = first_y; y < num_facts; ++y) {
+        const int cost_y = extension_costs[y];
+        if (cost_y == INT_MAX || fact_vars[y] == var_x) {
+            continue;
+        }
+        // Check if any entry can be improved at all (without considering {x, y} together).
+        const int lower_bound = max(cost_x, cost_y) + cost;
+        bool can_improve = false;
+        for (int e : eff) {
+            if (hm_table[rank(e, x, y)] > lower_bound) {
+                can_improve = true;
+                break;
+            }
+        }
+        if (!can_improve) {
+            continue;
+        }
+        const int c2 = extension_eval(op_id, x, y, cost_x, cost_y);
+        if (c2 == INT_MAX) {
+            continue;
+        }
+        for (int e : eff) {
+            update_hm_entry(e, x, y, c2 + cost);
+        }
+    }
+}
+
+/*
+ * Evaluates an atom set by computing the maximum value among all its subsets of size <= 3.
+ */
+int HThreeHeuristic::eval(const vector<int> &atom_set) const {
+    const size_t n = atom_set.size();
+    int max_value = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const int a = atom_set[i];
+        max_value = max(max_value, hm_table[rank(a)]);
+        for (size_t j = i + 1; j < n; ++j) {
+            const int b = atom_set[j];
+            max_value = max(max_value, hm_table[rank(a, b)]);
+            for (size_t k = j + 1; k < n; ++k) {
+                max_value = max(max_value, hm_table[rank(a, b, atom_set[k])]);
+            }
+            if (max_value == INT_MAX) {
+                return INT_MAX;
+            }
+        }
+    }
+    return max_value;
+}
+
+/*
+ * Evaluates pre(op) + {x}. pre(op) is already evaluated with pre_cost.
+ * Returns infinity if x is not a valid extension, i.e. it conflicts with eff(op) or pre(op).
+ */
+int HThreeHeuristic::extension_eval(int op_id, int x, int pre_cost) const {
+    const int var_x = fact_vars[x];
+    if (effect_var_cache[op_id][var_x]) {
+        return INT_MAX;
+    }
+    const vector<int> &pre = precondition_cache[op_id];
+    for (int fact : pre) {
+        if (fact_vars[fact] == var_x) {
+            return fact == x ? pre_cost : INT_MAX;
+        }
+    }
+    int max_value = max(pre_cost, hm_table[rank(x)]);
+    const size_t n = pre.size();
+    for (size_t i = 0; i < n && max_value != INT_MAX; ++i) {
+        max_value = max(max_value, hm_table[rank(x, pre[i])]);
+        for (size_t j = i + 1; j < n; ++j) {
+            max_value = max(max_value, hm_table[rank(x, pre[i], pre[j])]);
+        }
+    }
+    return max_value;
+}
+
+/*
+ * Evaluates pre(op) + {x, y}, given the values of pre(op) + {x} and pre(op) + {y}.
+ */
+int HThreeHeuristic::extension_eval(int op_id, int x, int y, int cost_x, int cost_y) const {
+    const vector<int> &pre = precondition_cache[op_id];
+    if (contains(pre, x)) {
+        return cost_y;
+    }
+    if (contains(pre, y)) {
+        return cost_x;
+    }
+    int max_value = max(max(cost_x, cost_y), hm_table[rank(x, y)]);
+    for (size_t i = 0; i < pre.size() && max_value != INT_MAX; ++i) {
+        max_value = max(max_value, hm_table[rank(x, y, pre[i])]);
+    }
+    return max_value;
+}
+
+bool HThreeHeuristic::contains(const vector<int> &atom_set, int fact) const {
+    return binary_search(atom_set.begin(), atom_set.end(), fact);
+}
+
+void HThreeHeuristic::update_hm_entry(int a, int val) {
+    int &entry = hm_table[rank(a)];
+    if (entry > val) {
+        entry = val;
+        const int facts[] = {a};
+        notify_operators(facts, 1);
+    }
+}
+
+void HThreeHeuristic::update_hm_entry(int a, int b, int val) {
+    int &entry = hm_table[rank(a, b)];
+    if (entry > val) {
+        entry = val;
+        const int facts[] = {a, b};
+        notify_operators(facts, 2);
+    }
+}
+
+void HThreeHeuristic::update_hm_entry(int a, int b, int c, int val) {
+    int &entry = hm_table[rank(a, b, c)];
+    if (entry > val) {
+        entry = val;
+        const int facts[] = {a, b, c};
+        notify_operators(facts, 3);
+    }
+}
+
+/*
+ * Queues all operators with an atom of the updated set in pre(op) (or empty pre(op)). The atoms of the set that
+ * are not in pre(op) form the changed extension of op.
+ */
+void HThreeHeuristic::notify_operators(const int *facts, int size) {
+    ++op_stamp;
+    for (int i = 0; i < size; ++i) {
+        for (int op_id : op_dict[facts[i]]) {
+            if (op_stamps[op_id] == op_stamp) {
+                continue;
+            }
+            op_stamps[op_id] = op_stamp;
+            op_queue.push(op_id);
+            if (op_cost[op_id] == INT_MAX) {
+                // The operator is processed completely once its precondition is reached.
+                continue;
+            }
+            int extension[3];
+            int extension_size = 0;
+            bool valid = true;
+            for (int j = 0; j < size; ++j) {
+                if (!contains(precondition_cache[op_id], facts[j])) {
+                    if (effect_var_cache[op_id][fact_vars[facts[j]]]) {
+                        valid = false;
+                        break;
+                    }
+                    extension[extension_size++] = facts[j];
+                }
+            }
+            if (!valid || extension_size == 0 || extension_size == 3) {
+                continue;
+            }
+            add_changed_extension(
+                op_id, extension[0], extension_size == 2 ? extension[1] : -1);
+        }
+    }
+}
+
+/*
+ * Appends {x} or {x, y} to the changed extensions of op. If the list is full, it overflows instead.
+ */
+void HThreeHeuristic::add_changed_extension(int op_id, int x, int y) {
+    vector<pair<int, int>> &extensions = get_changed_extensions(op_id);
+    if (changed_extensions_overflow[op_id]) {
+        return;
+    }
+    const pair<int, int> extension(x, y);
+    if (!extensions.empty() && extensions.back() == extension) {
+        return;
+    }
+    if (extensions.size() == max_changed_extensions) {
+        // The operator is processed completely, so the extensions are not needed.
+        changed_extensions_overflow[op_id] = true;
+        extensions.clear();
+        return;
+    }
+    if (extensions.capacity() < max_changed_extensions) {
+        // Buffers never grow beyond the size accounted for in the memory limit.
+        extensions.reserve(max_changed_extensions);
+    }
+    extensions.push_back(extension);
+}
+
+/*
+ * Returns the changed extensions of op, clearing them first if they stem from an earlier evaluation.
+ */
+vector<pair<int, int>> &HThreeHeuristic::get_changed_extensions(int op_id) {
+    vector<pair<int, int>> &extensions = changed_extensions[op_id];
+    if (changed_extensions_epoch[op_id] != epoch) {
+        reset_changed_extensions(op_id);
+        changed_extensions_epoch[op_id] = epoch;
+    }
+    return extensions;
+}
+
+void HThreeHeuristic::reset_changed_extensions(int op_id) {
+    changed_extensions[op_id].clear();
+    changed_extensions_overflow[op_id] = false;
+}
+
+class HThreeHeuristicFeature
+    : public plugins::TypedFeature<Evaluator, HThreeHeuristic> {
+public:
+    HThreeHeuristicFeature() : TypedFeature("h3") {
+        document_title("h^3 heuristic");
+        document_synopsis(
+            "Computes h^m for m = 3 with the data structures of the h^2 "
+            "implementation. The table contains an entry for every set of "
+            "up to three atoms, i.e., it grows cubically in the number of "
+            "atoms.");
+
+        add_option<int>(
+            "max_table_memory",
+            "maximum memory (in MB) for the h^3 table and the changed "
+            "extension lists of all threads. The planner exits with an "
+            "out-of-memory error before allocating more",
+            "1024",
+            plugins::Bounds("1", "infinity"));
+        add_heuristic_options_to_feature(*this, "h3");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "ignored");
+        document_language_support("axioms", "ignored");
+
+        document_property(
+            "admissible",
+            "yes for tasks without conditional effects or axioms");
+        document_property(
+            "consistent",
+            "yes for tasks without conditional effects or axioms");
+        document_property(
+            "safe",
+            "yes for tasks without conditional effects or axioms");
+        document_property("preferred operators", "no");
+    }
+
+    virtual shared_ptr<HThreeHeuristic> create_component(
+        const plugins::Options &opts,
+        const utils::Context &) const override {
+        return plugins::make_shared_from_arg_tuples<HThreeHeuristic>(
+            opts.get<int>("max_table_memory"),
+            get_heuristic_arguments_from_options(opts)
+            );
+    }
+};
+
+static plugins::FeaturePlugin<HThreeHeuristicFeature> _plugin;
+}
@@ -0,0 +1,130 @@
+#ifndef HEURISTICS_HTHREE_HEURISTIC_H
+#define HEURISTICS_HTHREE_HEURISTIC_H
+
+#include "htwo_heuristic.h"
+
+#include "../heuristic.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace plugins {
+class Options;
+}
+
+namespace hthree_heuristic {
+/*
+  The h^m heuristic for m = 3, using the design of HTwoHeuristic: all atom
+  sets of size <= 3 are ranked into a dense table, operators are processed
+  from a queue, and an operator whose precondition value did not change
+  only reconsiders the extensions that changed since it was processed last.
+
+  The table has num_facts^3 / 6 entries, so the heuristic is only feasible
+  for small tasks. Its size and the size of the changed extension lists
+  are checked against max_table_memory before they are allocated.
+*/
+class HThreeHeuristic : public Heuristic {
+    const bool has_cond_effects;
+    const int max_table_memory;
+    // Memory of the table and the changed extension lists in MB.
+    double memory_in_mb;
+    // Number of instances sharing the memory limit (see clone_for_worker).
+    std::shared_ptr<int> num_instances;
+
+    int num_facts;
+    // Global index of fact (var, 0) for every variable.
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+    /*
+      Sets {a}, {a, b} and {a, b, c} with a < b < c (global fact indices)
+      are ranked to a, pair_offset + C(b, 2) + a and
+      triple_offset + C(c, 3) + C(b, 2) + a.
+    */
+    std::size_t pair_offset;
+    std::size_t triple_offset;
+    std::vector<int> hm_table;
+
+    // Operator data, all fact sets are sorted global fact indices.
+    std::vector<std::vector<int>> precondition_cache;
+    std::vector<std::vector<int>> effect_cache;
+    std::vector<int> op_base_cost;
+    std::vector<std::vector<bool>> effect_var_cache;
+    // Stores for each fact the operators with the fact in pre and all operators with empty pre.
+    std::vector<std::vector<int>> op_dict;
+
+    htwo_heuristic::OperatorQueue op_queue;
+    std::vector<int> op_cost;
+    /*
+      Extensions ({x} or {x, y}, y = -1 for single atoms) that changed since the
+      operator was processed last. Lists are reset lazily via their epoch.
+      A list holds at most max_changed_extensions entries. If more extensions
+      change, the list overflows and the operator is processed completely.
+    */
+    std::vector<std::vector<std::pair<int, int>>> changed_extensions;
+    std::vector<int> changed_extensions_epoch;
+    std::vector<bool> changed_extensions_overflow;
+    std::size_t max_changed_extensions;
+    int epoch;
+    std::vector<std::pair<int, int>> processed_extensions;
+    // Avoids notifying an operator twice for the same table update.
+    std::vector<int> op_stamps;
+    int op_stamp;
+    // Extension values of all atoms for the operator that is processed.
+    std::vector<int> extension_costs;
+    // Avoids processing a changed single atom extension twice.
+    std::vector<int> fact_stamps;
+    int fact_stamp;
+    std::vector<int> goal_facts;
+    std::vector<int> state_facts;
+
+    static std::size_t num_table_entries(int num_facts);
+    std::size_t rank(int a) const {
+        return a;
+    }
+    std::size_t rank(int a, int b) const;
+    std::size_t rank(int a, int b, int c) const;
+
+    int get_fact_index(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    void init_operator_caches();
+    void init_hm_table();
+    void init_operator_queue();
+    void update_hm_table();
+
+    void process_operator(int op_id, int pre_cost);
+    void process_changed_extensions(int op_id, int pre_cost);
+    void compute_extension_costs(int op_id, int pre_cost);
+    void extend_with_pairs(int op_id, int x, int first_y);
+
+    int eval(const std::vector<int> &atom_set) const;
+    int extension_eval(int op_id, int x, int pre_cost) const;
+    int extension_eval(int op_id, int x, int y, int cost_x, int cost_y) const;
+    bool contains(const std::vector<int> &atom_set, int fact) const;
+
+    void update_hm_entry(int a, int val);
+    void update_hm_entry(int a, int b, int val);
+    void update_hm_entry(int a, int b, int c, int val);
+    void notify_operators(const int *facts, int size);
+    void add_changed_extension(int op_id, int x, int y);
+    std::vector<std::pair<int, int>> &get_changed_extensions(int op_id);
+    void reset_changed_extensions(int op_id);
+
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+
+public:
+    HThreeHeuristic(
+        int max_table_memory,
+        const std::shared_ptr<AbstractTask> &transform,
+        bool cache_estimates, const std::string &description,
+        utils::Verbosity verbosity);
+
+    virtual bool dead_ends_are_reliable() const override;
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
+};
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "../task_utils/task_properties.h"
 
+#include <cassert>
 #include <climits>
 
 using namespace std;
@@ -13,12 +14,17 @@ namespace htwo_heuristic {
  * Constructor for the HTwoHeuristic class.
  */
 HTwoHeuristic::HTwoHeuristic(
+    bool reachability_pass,
     const shared_ptr<AbstractTask> &transform,
     bool cache_estimates, const string &description,
     utils::Verbosity verbosity)
     : Heuristic(transform, cache_estimates, description, verbosity),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      reachability_pass(reachability_pass),
+      goals(task_properties::get_fact_pairs(task_proxy.get_goals())),
+      reachable_facts(0),
+      extension_candidates(0),
+      new_pairs(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing h^2" << endl;
         log << "The implementation of the h^m heuristic is preliminary." << endl;
@@ -26,6 +32,11 @@ HTwoHeuristic::HTwoHeuristic(
     init_operator_caches();
 }
 
+shared_ptr<Evaluator> HTwoHeuristic::clone_for_worker() const {
+    // Copies the table and scratch data, the operator caches are shared.
+    return make_shared<HTwoHeuristic>(*this);
+}
+
 
 /*
  * Computes the h^m value for a given state:
@@ -35,7 +46,13 @@ int HTwoHeuristic::compute_heuristic(const State &ancestor_state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     }
-    vector<FactPair> state_facts = task_properties::get_fact_pairs(state);
+    state_facts.clear();
+    for (FactProxy fact : state) {
+        state_facts.push_back(fact.get_pair());
+    }
+    if (reachability_pass && !compute_reachable_pairs(state_facts)) {
+        return DEAD_END;
+    }
     init_hm_table(state_facts);
     init_operator_queue();
     update_hm_table();
@@ -50,31 +67,48 @@ int HTwoHeuristic::compute_heuristic(const State &ancestor_state) {
 * Sets up all auxiliary operator data structures. Since these do not change throughout the search process, this is done once in the constructor.
 */
 void HTwoHeuristic::init_operator_caches() {
+    fact_offsets.clear();
+    index_to_fact.clear();
+    num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            index_to_fact.emplace_back(var.get_id(), value);
+        }
+    }
+    if (reachability_pass) {
+        init_reachability_data();
+    }
+
   	vector<int> empty_pre_op = {};
     for (auto op : task_proxy.get_operators()) {
         if (op.get_preconditions().empty()) {
             empty_pre_op.push_back(op.get_id());
         }
     }
-    const int num_variables = task_proxy.get_variables().size();
-    for (int i = 0; i < num_variables; ++i) {
-        const int domain1_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain1_size; ++j) {
-			op_dict[FactPair(i, j)] = empty_pre_op;
-        }
-    }
-    precondition_cache = {};
-    partial_effect_cache = {};
-    effect_conflict_cache.assign(task_proxy.get_operators().size(), std::vector<bool>(task_proxy.get_variables().size(), false));
+    operator_caches = make_shared<OperatorCaches>();
+    operator_caches->op_dict.assign(num_facts, empty_pre_op);
+    const int num_operators = task_proxy.get_operators().size();
+    op_queue.init(num_operators);
+    op_cost.assign(num_operators, INT_MAX);
+    changed_entries.assign(num_operators, {});
+    changed_entries_epoch.assign(num_operators, 0);
+    epoch = 0;
+    fact_stamps.assign(num_facts, 0);
+    fact_stamp = 0;
+    operator_caches->precondition_cache = {};
+    operator_caches->partial_effect_cache = {};
+    operator_caches->effect_conflict_cache.assign(task_proxy.get_operators().size(), std::vector<bool>(task_proxy.get_variables().size(), false));
 	for (OperatorProxy op : task_proxy.get_operators()) {
         // Setup precondition cache
         vector<FactPair> preconditions = task_properties::get_fact_pairs(op.get_preconditions());
     	sort(preconditions.begin(), preconditions.end());
-    	precondition_cache.push_back(preconditions);
+    	operator_caches->precondition_cache.push_back(preconditions);
 
         // Setup op_dict
         for (auto pre : preconditions) {
-        	op_dict[pre].push_back(op.get_id());
+        	operator_caches->op_dict[get_fact_index(pre)].push_back(op.get_id());
         }
 
         // Check for operators without preconditions -> automatically add to op_dict
@@ -86,62 +120,138 @@ void HTwoHeuristic::init_operator_caches() {
         vector<FactPair> effects;
     	for (EffectProxy eff : op.get_effects()) {
         	effects.push_back(eff.get_fact().get_pair());
-            effect_conflict_cache[op.get_id()][eff.get_fact().get_pair().var] = true;
+            operator_caches->effect_conflict_cache[op.get_id()][eff.get_fact().get_pair().var] = true;
     	}
     	sort(effects.begin(), effects.end());
-		partial_effect_cache.push_back(generate_all_pairs(effects));
+		operator_caches->partial_effect_cache.push_back(generate_all_pairs(effects));
     }
 }
 
+void HTwoHeuristic::init_reachability_data() {
+    reachable_pairs.assign(num_facts, Bitset(num_facts));
+    reachable_facts = Bitset(num_facts);
+    extension_candidates = Bitset(num_facts);
+    new_pairs = Bitset(num_facts);
+}
+
 /*
- * Initializes hm table.
- * If entry is contained in init_state_atoms assigns 0, and infinity otherwise.
- * Pair containing variable -1 at second position indicates single fact.
+ * Computes the pairs reachable from state_facts, i.e., the entries that receive a finite value in the
+ * cost-based fixpoint. Operators are applied in rounds until no new pair is reached. Each round works on whole
+ * words: the atoms that can extend an effect of op are the reachable atoms that form a reachable pair with every
+ * atom in pre(op). Returns false if the goal is unreachable.
  */
-void HTwoHeuristic::init_hm_table(const std::vector<FactPair> &init_state_atoms) {
-    unordered_set<FactPair, FactPairHash> state_atoms_set(init_state_atoms.begin(), init_state_atoms.end());
-        state_atoms_set.insert(FactPair(-1, -1));
-
-    const int num_variables = task_proxy.get_variables().size();
-    for (int i = 0; i < num_variables; ++i) {
-        const int domain1_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain1_size; ++j) {
-            Pair single_pair(FactPair(i, j), FactPair(-1, -1));
-            hm_table[single_pair] = check_in_initial_state(single_pair, state_atoms_set);
+bool HTwoHeuristic::compute_reachable_pairs(const vector<FactPair> &state_facts) {
+    for (Bitset &row : reachable_pairs) {
+        row.reset();
+    }
+    reachable_facts.reset();
+    for (size_t i = 0; i < state_facts.size(); ++i) {
+        const int fact1 = get_fact_index(state_facts[i]);
+        for (size_t j = i; j < state_facts.size(); ++j) {
+            set_reachable(fact1, get_fact_index(state_facts[j]));
+        }
+    }
 
-            for (int k = i + 1; k < num_variables; ++k) {
-                const int domain2_size = task_proxy.get_variables()[k].get_domain_size();
-                for (int l = 0; l < domain2_size; ++l) {
-                    Pair pair(FactPair(i, j), FactPair(k, l));
-                    hm_table[pair] = check_in_initial_state(pair, state_atoms_set);
+    const auto &variables = task_proxy.get_variables();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t op_id = 0; op_id < operator_caches->precondition_cache.size(); ++op_id) {
+            const vector<FactPair> &pre = operator_caches->precondition_cache[op_id];
+            if (!is_reachable(pre)) {
+                continue;
+            }
+            extension_candidates.set();
+            extension_candidates &= reachable_facts;
+            for (const FactPair &fact : pre) {
+                extension_candidates &= reachable_pairs[get_fact_index(fact)];
+            }
+            for (const Pair &partial_eff : operator_caches->partial_effect_cache[op_id]) {
+                if (partial_eff.second.var == -1) {
+                    const int var = partial_eff.first.var;
+                    const int offset = fact_offsets[var];
+                    for (int value = 0; value < variables[var].get_domain_size(); ++value) {
+                        extension_candidates.reset(offset + value);
+                    }
+                }
+            }
+            for (const Pair &partial_eff : operator_caches->partial_effect_cache[op_id]) {
+                const int eff_fact = get_fact_index(partial_eff.first);
+                if (partial_eff.second.var != -1) {
+                    changed |= set_reachable(eff_fact, get_fact_index(partial_eff.second));
+                    continue;
+                }
+                changed |= set_reachable(eff_fact, eff_fact);
+                new_pairs.set();
+                new_pairs &= extension_candidates;
+                new_pairs -= reachable_pairs[eff_fact];
+                if (new_pairs.none()) {
+                    continue;
+                }
+                changed = true;
+                reachable_pairs[eff_fact] |= new_pairs;
+                for (size_t fact = new_pairs.find_first(); fact < new_pairs.size(); fact = new_pairs.find_next(fact)) {
+                    reachable_pairs[fact].set(eff_fact);
                 }
             }
         }
     }
+    return is_reachable(goals);
 }
 
 /*
- * Check if Pair is contained in initial state atoms. Unordered set allows constant time lookup.
+ * Marks {fact1, fact2} as reachable. Returns true if it was not reachable before.
  */
-int HTwoHeuristic::check_in_initial_state(
-    const Pair &hm_entry, const std::unordered_set<FactPair, FactPairHash> &state_atoms_set) const {
-    bool found_first = state_atoms_set.find(hm_entry.first) != state_atoms_set.end();
-    bool found_second = (state_atoms_set.find(hm_entry.second) != state_atoms_set.end());
-    return (found_first && found_second) ? 0 : INT_MAX;
+bool HTwoHeuristic::set_reachable(int fact1, int fact2) {
+    if (reachable_pairs[fact1].test(fact2)) {
+        return false;
+    }
+    reachable_pairs[fact1].set(fact2);
+    reachable_pairs[fact2].set(fact1);
+    if (fact1 == fact2) {
+        reachable_facts.set(fact1);
+    }
+    return true;
+}
+
+bool HTwoHeuristic::is_reachable(const vector<FactPair> &atom_set) const {
+    const size_t n = atom_set.size();
+    for (size_t i = 0; i < n; ++i) {
+        const Bitset &row = reachable_pairs[get_fact_index(atom_set[i])];
+        for (size_t j = i; j < n; ++j) {
+            if (!row.test(get_fact_index(atom_set[j]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Initializes hm table.
+ * Pairs (and single facts) contained in init_state_atoms are assigned 0, all other entries infinity.
+ */
+void HTwoHeuristic::init_hm_table(const std::vector<FactPair> &init_state_atoms) {
+    hm_table.assign(get_index(num_facts - 1, num_facts - 1) + 1, INT_MAX);
+    for (size_t i = 0; i < init_state_atoms.size(); ++i) {
+        const int fact1 = get_fact_index(init_state_atoms[i]);
+        for (size_t j = i; j < init_state_atoms.size(); ++j) {
+            hm_table[get_index(fact1, get_fact_index(init_state_atoms[j]))] = 0;
+        }
+    }
 }
 
 /*
  * Adds operators to queue if they are applicable in the initial state.
  */
 void HTwoHeuristic::init_operator_queue() {
-  	op_cost.assign(task_proxy.get_operators().size(), INT_MAX);
-    changed_entries.assign(task_proxy.get_operators().size(), unordered_set<FactPair, FactPairHash>());
-	for (OperatorProxy op : task_proxy.get_operators()) {
-        const int op_id = op.get_id();
+    fill(op_cost.begin(), op_cost.end(), INT_MAX);
+    // Invalidates all changed entries of the last evaluation.
+    ++epoch;
+    for (size_t op_id = 0; op_id < operator_caches->precondition_cache.size(); ++op_id) {
     	// Initialize operator queue with applicable operators
-        if (is_op_applicable(precondition_cache[op_id])) {
-            op_queue.push_back(op_id);
-            is_op_in_queue.insert(op_id);
+        if (is_op_applicable(operator_caches->precondition_cache[op_id])) {
+            op_queue.push(op_id);
         }
     }
 }
@@ -150,9 +260,9 @@ void HTwoHeuristic::init_operator_queue() {
  * Check if op is applicable in initial state. Only works for initial state as it only considers single atom table entries.
  * Precondition-free operators are always applicable.
  */
-bool HTwoHeuristic::is_op_applicable(vector<FactPair> pre) const {
-	for (auto fact : pre) {
-    	if (hm_table.find(Pair(fact, FactPair(-1, -1)))->second != 0) {
+bool HTwoHeuristic::is_op_applicable(const vector<FactPair> &pre) const {
+	for (const FactPair &fact : pre) {
+    	if (hm_table[get_index(fact)] != 0) {
         	return false;
         }
     }
@@ -165,21 +275,19 @@ bool HTwoHeuristic::is_op_applicable(vector<FactPair> pre) const {
  */
 void HTwoHeuristic::update_hm_table() {
     while (!op_queue.empty()) {
-        const int op_id = op_queue.front();
+        const int op_id = op_queue.pop();
         OperatorProxy op = task_proxy.get_operators()[op_id];
         const int cost = op.get_cost();
-        op_queue.pop_front();
-        is_op_in_queue.erase(op_id);
-        int c1 = eval(precondition_cache[op_id]);
+        int c1 = eval(operator_caches->precondition_cache[op_id]);
         if (c1 == op_cost[op_id]) {
           	if (c1 != INT_MAX) {
 		    	extend_changed_entry(op);
         	}
             continue;
         }
-        changed_entries[op_id].clear();
+        get_changed_entries(op_id).clear();
         op_cost[op_id] = c1;
-        for (Pair &partial_eff : partial_effect_cache[op_id]) {
+        for (Pair &partial_eff : operator_caches->partial_effect_cache[op_id]) {
         	update_hm_entry(partial_eff, c1 + cost);
             if (partial_eff.second.var == -1) {
                 extend_entry(partial_eff.first, op, c1);
@@ -196,21 +304,26 @@ void HTwoHeuristic::extend_entry(const FactPair &f, const OperatorProxy &op, int
     const auto &variables = task_proxy.get_variables();
     const int op_id = op.get_id();
     const int op_cost = op.get_cost();
-    const vector<FactPair> &pre = precondition_cache[op_id];
+    const vector<FactPair> &pre = operator_caches->precondition_cache[op_id];
+    const int f_index = get_fact_index(f);
     for (size_t i = 0; i < variables.size(); ++i) {
-        if (effect_conflict_cache[op_id][i]) {
+        if (operator_caches->effect_conflict_cache[op_id][i]) {
         	continue;
         }
         const int domain_size = variables[i].get_domain_size();
     	for (int j = 0; j < domain_size; ++j) {
         	const FactPair extend_fact = FactPair(i, j);
             // Check if extend_fact is reachable
-            if (hm_table.find(Pair(extend_fact, FactPair(-1, -1)))->second == INT_MAX) {
+            if (hm_table[get_index(extend_fact)] == INT_MAX) {
             	continue;
             }
+            // Skip pairs that the reachability pass found unreachable
+            if (reachability_pass && !reachable_pairs[f_index].test(get_fact_index(extend_fact))) {
+                continue;
+            }
             const Pair hm_pair = f.var > extend_fact.var ? Pair(extend_fact, f) : Pair(f, extend_fact);
             // Check if table entry can be updated with current op (without extend_Fact considered)
-            if (hm_table.find(hm_pair)->second <= eval + op_cost) {
+            if (hm_table[get_index(f, extend_fact)] <= eval + op_cost) {
             	continue;
             }
         	const int c2 = extend_eval(extend_fact, pre, eval);
@@ -227,14 +340,25 @@ void HTwoHeuristic::extend_entry(const FactPair &f, const OperatorProxy &op, int
  */
 void HTwoHeuristic::extend_changed_entry(const OperatorProxy &op) {
     const int op_id = op.get_id();
-    const vector<FactPair> &pre = precondition_cache[op_id];
+    const vector<FactPair> &pre = operator_caches->precondition_cache[op_id];
     const int op_base_cost = op.get_cost();
     const int cost = op_cost[op_id];
-	for (EffectProxy eff : op.get_effects()) {
-    	FactPair effect = eff.get_fact().get_pair();
-        for (FactPair entry : changed_entries[op_id]) {
+    /*
+      Entries that change while processing op are collected in the (then empty) list of op, which is queued
+      again by add_operator_to_queue.
+    */
+    processed_entries.swap(get_changed_entries(op_id));
+    ++fact_stamp;
+    for (int entry_index : processed_entries) {
+        if (fact_stamps[entry_index] == fact_stamp) {
+            continue;
+        }
+        fact_stamps[entry_index] = fact_stamp;
+        const FactPair entry = index_to_fact[entry_index];
+        for (EffectProxy eff : op.get_effects()) {
+            FactPair effect = eff.get_fact().get_pair();
         	Pair hm_pair = effect.var > entry.var ? Pair(entry, effect) : Pair(effect, entry);
-            if (hm_table.find(hm_pair)->second <= cost + op_base_cost) {
+            if (hm_table[get_index(effect, entry)] <= cost + op_base_cost) {
             	continue;
             }
             int c2 = extend_eval(entry, pre, cost);
@@ -243,21 +367,25 @@ void HTwoHeuristic::extend_changed_entry(const OperatorProxy &op) {
         	}
         }
     }
+    processed_entries.clear();
 }
 
 /*
  * Evaluates atom set by computing the maximum heuristic value among all its subsets (subset size <= 2). Used for pre(op) and goal.
  */
 int HTwoHeuristic::eval(const vector<FactPair> &atom_set) const {
-    vector<Pair> pairs = generate_all_pairs(atom_set);
+    const size_t n = atom_set.size();
     int max = 0;
-    for (Pair &pair : pairs) {
-        int h = hm_table.find(pair)->second;
-        if (h > max) {
-        	if (h == INT_MAX) {
-            	return INT_MAX;
+    for (size_t i = 0; i < n; ++i) {
+        const int fact1 = get_fact_index(atom_set[i]);
+        for (size_t j = i; j < n; ++j) {
+            int h = hm_table[get_index(fact1, get_fact_index(atom_set[j]))];
+            if (h > max) {
+                if (h == INT_MAX) {
+                    return INT_MAX;
+                }
+                max = h;
             }
-        	max = h;
         }
     }
     return max;
@@ -267,7 +395,8 @@ int HTwoHeuristic::eval(const vector<FactPair> &atom_set) const {
  * Evaluates extend_fact + pre. pre already evaluated with integer eval. Runtime is linear in |pre|.
  */
 int HTwoHeuristic::extend_eval(const FactPair &extend_fact, const vector<FactPair> &pre, int eval) const {
-    int fact_eval = hm_table.find(Pair(extend_fact, FactPair(-1, -1)))->second;
+    const int extend_index = get_fact_index(extend_fact);
+    int fact_eval = hm_table[get_index(extend_index, extend_index)];
     int max = eval > fact_eval? eval : fact_eval;
     for (FactPair fact0 : pre) {
       	if (fact0.var == extend_fact.var) {
@@ -278,8 +407,7 @@ int HTwoHeuristic::extend_eval(const FactPair &extend_fact, const vector<FactPai
             // extend_fact ∈ pre
         	return eval;
         }
-        Pair key = (fact0.var < extend_fact.var) ? Pair(fact0, extend_fact) : Pair(extend_fact, fact0);
-        int h = hm_table.find(key)->second;
+        int h = hm_table[get_index(get_fact_index(fact0), extend_index)];
 
         if (h > max) {
         	if (h == INT_MAX) {
@@ -296,31 +424,41 @@ int HTwoHeuristic::extend_eval(const FactPair &extend_fact, const vector<FactPai
  */
 void HTwoHeuristic::add_operator_to_queue(const Pair &p) {
     if (p.second.var == -1) {
-    	for (int op_id : op_dict[p.first]) {
-        	if (is_op_in_queue.find(op_id) == is_op_in_queue.end()) {
-            	op_queue.push_back(op_id);
-            	is_op_in_queue.insert(op_id);
-        	}
+    	for (int op_id : operator_caches->op_dict[get_fact_index(p.first)]) {
+            op_queue.push(op_id);
     	}
         return;
     }
-    for (int op_id : op_dict[p.first]) {
-        if (is_op_in_queue.find(op_id) == is_op_in_queue.end()) {
-            op_queue.push_back(op_id);
-            is_op_in_queue.insert(op_id);
-        }
-        if (changed_entries[op_id].find(p.second) == changed_entries[op_id].end() && !effect_conflict_cache[op_id][p.second.var]) {
-    		 changed_entries[op_id].insert(p.second);
-    	}
+    for (int op_id : operator_caches->op_dict[get_fact_index(p.first)]) {
+        op_queue.push(op_id);
+        add_changed_entry(op_id, p.second);
     }
-    for (int op_id : op_dict[p.second]) {
-        if (is_op_in_queue.find(op_id) == is_op_in_queue.end()) {
-            op_queue.push_back(op_id);
-            is_op_in_queue.insert(op_id);
-        }
-        if (changed_entries[op_id].find(p.first) == changed_entries[op_id].end() && !effect_conflict_cache[op_id][p.first.var]) {
-    		 changed_entries[op_id].insert(p.first);
-    	}
+    for (int op_id : operator_caches->op_dict[get_fact_index(p.second)]) {
+        op_queue.push(op_id);
+        add_changed_entry(op_id, p.first);
+    }
+}
+
+/*
+ * Returns the changed entries of op, clearing them first if they stem from an earlier evaluation.
+ */
+vector<int> &HTwoHeuristic::get_changed_entries(int op_id) {
+    vector<int> &entries = changed_entries[op_id];
+    if (changed_entries_epoch[op_id] != epoch) {
+        entries.clear();
+        changed_entries_epoch[op_id] = epoch;
+    }
+    return entries;
+}
+
+void HTwoHeuristic::add_changed_entry(int op_id, const FactPair &fact) {
+    if (operator_caches->effect_conflict_cache[op_id][fact.var]) {
+        return;
+    }
+    vector<int> &entries = get_changed_entries(op_id);
+    const int fact_index = get_fact_index(fact);
+    if (entries.empty() || entries.back() != fact_index) {
+        entries.push_back(fact_index);
     }
 }
 
@@ -329,8 +467,9 @@ void HTwoHeuristic::add_operator_to_queue(const Pair &p) {
  * Affected operators are potentially added to queue.
  */
 void HTwoHeuristic::update_hm_entry(const Pair &p, int val) {
-    if (hm_table[p] > val) {
-        hm_table[p] = val;
+    int &entry = hm_table[get_index(p)];
+    if (entry > val) {
+        entry = val;
         add_operator_to_queue(p);
     }
 }
@@ -355,9 +494,20 @@ vector<HTwoHeuristic::Pair> HTwoHeuristic::generate_all_pairs(const vector<FactP
 
 void HTwoHeuristic::dump_table() const {
     stringstream ss;
-    for (auto entry : hm_table) {
-        Pair pair = entry.first;
-        ss << "[" << pair.first.var << " = " << pair.first.value << ", " << pair.second.var << " = " << pair.second.value << "] = " << entry.second << endl;
+    const int num_variables = task_proxy.get_variables().size();
+    for (int i = 0; i < num_variables; ++i) {
+        const int domain1_size = task_proxy.get_variables()[i].get_domain_size();
+        for (int j = 0; j < domain1_size; ++j) {
+            FactPair f1(i, j);
+            ss << "[" << i << " = " << j << ", -1 = -1] = " << hm_table[get_index(f1)] << endl;
+            for (int k = i + 1; k < num_variables; ++k) {
+                const int domain2_size = task_proxy.get_variables()[k].get_domain_size();
+                for (int l = 0; l < domain2_size; ++l) {
+                    ss << "[" << i << " = " << j << ", " << k << " = " << l << "] = "
+                       << hm_table[get_index(f1, FactPair(k, l))] << endl;
+                }
+            }
+        }
     }
     log << ss.str() << endl;
 }
@@ -368,6 +518,13 @@ public:
     HTwoHeuristicFeature() : TypedFeature("h2") {
         document_title("h^2 heuristic");
 
+        add_option<bool>(
+            "reachability_pass",
+            "compute the reachable pairs with bitsets before the cost-based "
+            "fixpoint. Detects dead ends without the fixpoint and skips "
+            "unreachable pairs when extending effects. Pays off on tasks "
+            "with many unreachable pairs or dead ends",
+            "false");
         add_heuristic_options_to_feature(*this, "h2");
 
         document_language_support("action costs", "supported");
@@ -390,6 +547,7 @@ public:
         const plugins::Options &opts,
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<HTwoHeuristic>(
+            opts.get<bool>("reachability_pass"),
             get_heuristic_arguments_from_options(opts)
             );
     }
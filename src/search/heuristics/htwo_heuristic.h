@@ -3,12 +3,15 @@
 
 #include "../heuristic.h"
 
+#include "../algorithms/dynamic_bitset.h"
+
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <deque>
+#include <utility>
 
 
 
@@ -17,68 +20,164 @@ class Options;
 }
 
 namespace htwo_heuristic {
+/*
+  FIFO queue of operator ids backed by a ring buffer. Every operator is
+  contained at most once, so the capacity is the number of operators and
+  no memory is allocated after init.
+*/
+class OperatorQueue {
+    std::vector<int> buffer;
+    std::vector<bool> contained;
+    std::size_t head = 0;
+    std::size_t num_entries = 0;
+public:
+    void init(int num_operators) {
+        buffer.assign(num_operators, -1);
+        contained.assign(num_operators, false);
+        head = 0;
+        num_entries = 0;
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    // Adds op_id at the back unless it is already in the queue.
+    void push(int op_id) {
+        if (contained[op_id]) {
+            return;
+        }
+        contained[op_id] = true;
+        std::size_t tail = head + num_entries;
+        if (tail >= buffer.size()) {
+            tail -= buffer.size();
+        }
+        buffer[tail] = op_id;
+        ++num_entries;
+    }
+
+    int pop() {
+        const int op_id = buffer[head];
+        if (++head == buffer.size()) {
+            head = 0;
+        }
+        --num_entries;
+        contained[op_id] = false;
+        return op_id;
+    }
+};
+
 class HTwoHeuristic : public Heuristic {
     protected:
 
     // parameters
     const bool has_cond_effects;
+    // If true, the pairs reachable from the state are computed with bitsets before the cost-based fixpoint.
+    const bool reachability_pass;
     std::vector<FactPair> goals;
 
 
     struct Pair {
         FactPair first;
         FactPair second;
-        std::size_t hash;
 
-        Pair(const FactPair &f, const FactPair &s) : first(f), second(s), hash(compute_hash(first, second)) {}
+        Pair(const FactPair &f, const FactPair &s) : first(f), second(s) {}
 
         bool operator==(const Pair &other) const {
             return first == other.first && second == other.second;
         }
-
-    protected:
-        static std::size_t compute_hash(const FactPair &f1, const FactPair &f2) {
-            const int MOD = 100003; // Prime
-            std::size_t h1 = f1.var * MOD + f1.value;
-            std::size_t h2 = f2.var * MOD + f2.value;
-            return h2 * MOD + h1;
-        }
-    };
-    struct PairHash {
-        std::size_t operator()(const Pair &pair) const {
-            return pair.hash;
-        }
-    };
-
-    struct FactPairHash {
-        size_t operator()(const FactPair &fact) const {
-            return fact.var * 100003 + fact.value;
-        }
     };
 
     // data structures
 protected:
-    std::unordered_map<Pair, int, PairHash> hm_table;
-    std::deque<int> op_queue;
+    /*
+      Dense triangular table over global fact indices. The entry of the pair
+      {a, b} with a <= b is stored at b * (b + 1) / 2 + a, single facts are
+      stored on the diagonal (a == b).
+    */
+    std::vector<int> hm_table;
+    // Global index of fact (var, 0) for every variable.
+    std::vector<int> fact_offsets;
+    int num_facts;
+    OperatorQueue op_queue;
 
     // Auxiliary data structurs that speed up implementation (Could also be removed in case of memory issues)
-    std::unordered_set<int> is_op_in_queue; // stores all operators that are in queue for constant time look up
-    std::vector<std::vector<FactPair>> precondition_cache;
-    std::vector<std::vector<Pair>> partial_effect_cache;
-    std::vector<std::vector<bool>> effect_conflict_cache; // Stores if variable is in effect of operator
+    struct OperatorCaches {
+        std::vector<std::vector<FactPair>> precondition_cache;
+        std::vector<std::vector<Pair>> partial_effect_cache;
+        std::vector<std::vector<bool>> effect_conflict_cache; // Stores if variable is in effect of operator
+        // Stores for each fact (by global index) a list of operators where the fact occures in pre
+        std::vector<std::vector<int>> op_dict;
+    };
+    /*
+      The caches are not modified after init_operator_caches, so clones of
+      the heuristic share them.
+    */
+    std::shared_ptr<OperatorCaches> operator_caches;
+
+    std::vector<int> op_cost;
+    /*
+      Atoms (by global index) that changed in a pair with a precondition atom since the operator was last
+      processed. The lists may contain duplicates, they are filtered when processed. A list is only valid if its
+      stamp equals the current epoch, this resets all lists without touching them in every evaluation.
+    */
+    std::vector<std::vector<int>> changed_entries;
+    std::vector<int> changed_entries_epoch;
+    int epoch;
+    std::vector<int> processed_entries;
+    // Marks facts already handled in the current call of extend_changed_entry.
+    std::vector<int> fact_stamps;
+    int fact_stamp;
+    // Reused buffers to avoid allocations per evaluation.
+    std::vector<FactPair> state_facts;
+    // Fact of every global fact index.
+    std::vector<FactPair> index_to_fact;
+
+    using Bitset = dynamic_bitset::DynamicBitset<std::uint64_t>;
+    /*
+      Result of the reachability pass (only used if reachability_pass is set).
+      Bit g of reachable_pairs[f] is set iff the pair {f, g} is reachable (f == g for single facts).
+    */
+    std::vector<Bitset> reachable_pairs;
+    Bitset reachable_facts;
+    Bitset extension_candidates;
+    Bitset new_pairs;
+
+    int get_fact_index(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    static std::size_t get_index(int a, int b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+        return static_cast<std::size_t>(b) * (b + 1) / 2 + a;
+    }
+
+    std::size_t get_index(const FactPair &f) const {
+        return get_index(get_fact_index(f), get_fact_index(f));
+    }
 
-   	std::vector<int> op_cost;
-    std::vector<std::unordered_set<FactPair, FactPairHash>> changed_entries;
-    // Stores for each FactPair a list of operators where the fact occures in pre
-    mutable std::unordered_map<FactPair, std::vector<int>, FactPairHash> op_dict;
+    std::size_t get_index(const FactPair &f1, const FactPair &f2) const {
+        return get_index(get_fact_index(f1), get_fact_index(f2));
+    }
+
+    std::size_t get_index(const Pair &p) const {
+        if (p.second.var == -1) {
+            return get_index(p.first);
+        }
+        return get_index(p.first, p.second);
+    }
 
     // Methods for initalizing data structures
+    void init_reachability_data();
+    bool compute_reachable_pairs(const std::vector<FactPair> &state_facts);
+    bool set_reachable(int fact1, int fact2);
+    bool is_reachable(const std::vector<FactPair> &atom_set) const;
     void init_hm_table(const std::vector<FactPair> &init_state_atoms);
-    int check_in_initial_state(
-    const Pair &hm_entry, const std::unordered_set<FactPair, FactPairHash> &state_facts_set) const;
     void init_operator_caches();
     void init_operator_queue();
-    bool is_op_applicable(std::vector<FactPair> pre) const;
+    bool is_op_applicable(const std::vector<FactPair> &pre) const;
 
     // Methods for updating table
     void update_hm_table();
@@ -89,6 +188,8 @@ protected:
 
     inline void update_hm_entry(const Pair &p, int val);
     inline void add_operator_to_queue(const Pair &p);
+    std::vector<int> &get_changed_entries(int op_id);
+    inline void add_changed_entry(int op_id, const FactPair &fact);
 
 	std::vector<Pair> generate_all_pairs(const std::vector<FactPair> &base_atom_set) const;
 
@@ -99,10 +200,12 @@ protected:
 
 public:
     HTwoHeuristic(
+        bool reachability_pass,
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
 
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
@@ -24,6 +24,18 @@ LandmarkCutHeuristic::LandmarkCutHeuristic(
     }
 }
 
+LandmarkCutHeuristic::LandmarkCutHeuristic(const LandmarkCutHeuristic &other)
+    : Heuristic(other),
+      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)) {
+}
+
+LandmarkCutHeuristic::~LandmarkCutHeuristic() {
+}
+
+shared_ptr<Evaluator> LandmarkCutHeuristic::clone_for_worker() const {
+    return shared_ptr<Evaluator>(new LandmarkCutHeuristic(*this));
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int total_cost = 0;
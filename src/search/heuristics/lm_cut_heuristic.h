@@ -16,11 +16,20 @@ class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
     virtual int compute_heuristic(const State &ancestor_state) override;
+
+    /*
+      The landmark generator interleaves the relaxed task with the data of
+      the current computation, so the copy builds its own generator.
+    */
+    LandmarkCutHeuristic(const LandmarkCutHeuristic &other);
 public:
     LandmarkCutHeuristic(
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
+    virtual ~LandmarkCutHeuristic() override;
+
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
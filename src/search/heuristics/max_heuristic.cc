@@ -23,12 +23,12 @@ namespace max_heuristic {
  */
 
 // construction and destruction
-HSPMaxHeuristic::HSPMaxHeuristic(bool pi_m_compilation,
+HSPMaxHeuristic::HSPMaxHeuristic(bool pi_m_compilation, int pi_m_threads,
     tasks::AxiomHandlingType axioms,
     const shared_ptr<AbstractTask> &transform, bool cache_estimates,
     const string &description, utils::Verbosity verbosity)
     : RelaxationHeuristic(
-          axioms, get_pi_m_compiled_task(pi_m_compilation, transform), cache_estimates, description,
+          axioms, get_pi_m_compiled_task(pi_m_compilation, pi_m_threads, transform), cache_estimates, description,
           verbosity) {
 
     if (log.is_at_least_normal()) {
@@ -36,6 +36,14 @@ HSPMaxHeuristic::HSPMaxHeuristic(bool pi_m_compilation,
     }
 }
 
+HSPMaxHeuristic::HSPMaxHeuristic(const HSPMaxHeuristic &other)
+    : RelaxationHeuristic(other) {
+}
+
+shared_ptr<Evaluator> HSPMaxHeuristic::clone_for_worker() const {
+    return shared_ptr<Evaluator>(new HSPMaxHeuristic(*this));
+}
+
 // heuristic computation
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
@@ -74,7 +82,7 @@ void HSPMaxHeuristic::relaxed_exploration() {
             continue;
         if (prop->is_goal && --unsolved_goals == 0)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
+        for (OpID op_id : precondition_of_pool->get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
             UnaryOperator *unary_op = get_operator(op_id);
             unary_op->cost = max(unary_op->cost,
@@ -106,9 +114,9 @@ int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
 }
 
 shared_ptr<AbstractTask> HSPMaxHeuristic::get_pi_m_compiled_task(
-    bool pi_m_compilation, const shared_ptr<AbstractTask> &original_task) {
+    bool pi_m_compilation, int pi_m_threads, const shared_ptr<AbstractTask> &original_task) {
     if (pi_m_compilation) {
-        return extra_tasks::build_pi_m_compiled_task(original_task);
+        return extra_tasks::build_pi_m_compiled_task(original_task, pi_m_threads);
     }
     return original_task;
 }
@@ -121,6 +129,13 @@ public:
 
         relaxation_heuristic::add_relaxation_heuristic_options_to_feature(*this, "hmax");
         add_option<bool>("pi_m_compilation", "", "False");
+        add_option<int>(
+            "pi_m_threads",
+            "number of threads for building the Pi^m compiled task "
+            "(0 = one per hardware thread). The compiled task does not "
+            "depend on this value",
+            "1",
+            plugins::Bounds("0", "infinity"));
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "supported (ignored for pi^m compilation)");
@@ -135,7 +150,8 @@ public:
         const plugins::Options &opts,
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<HSPMaxHeuristic>(
-            opts.get<bool>("pi_m_compilation"), relaxation_heuristic::get_relaxation_heuristic_arguments_from_options(opts)
+            opts.get<bool>("pi_m_compilation"), opts.get<int>("pi_m_threads"),
+            relaxation_heuristic::get_relaxation_heuristic_arguments_from_options(opts)
             );
     }
 };
@@ -23,7 +23,7 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     void relaxed_exploration();
 
     std::shared_ptr<AbstractTask> get_pi_m_compiled_task(
-    bool pi_m_compilation, const std::shared_ptr<AbstractTask> &original_task);
+    bool pi_m_compilation, int pi_m_threads, const std::shared_ptr<AbstractTask> &original_task);
 
     void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
@@ -36,13 +36,17 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     }
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+
+    // Copy constructor for clone_for_worker. The copy gets its own queue.
+    HSPMaxHeuristic(const HSPMaxHeuristic &other);
 public:
-    HSPMaxHeuristic(bool pi_m_compilation,
+    HSPMaxHeuristic(bool pi_m_compilation, int pi_m_threads,
         tasks::AxiomHandlingType axioms,
         const std::shared_ptr<AbstractTask> &transform,
         bool cache_estimates, const std::string &description,
         utils::Verbosity verbosity);
 
+    virtual std::shared_ptr<Evaluator> clone_for_worker() const override;
 };
 }
 
@@ -56,7 +56,9 @@ RelaxationHeuristic::RelaxationHeuristic(
     const string &description, utils::Verbosity verbosity)
     : Heuristic(tasks::get_default_value_axioms_task_if_needed(
                     transform, axioms),
-                cache_estimates, description, verbosity) {
+                cache_estimates, description, verbosity),
+      preconditions_pool(make_shared<array_pool::ArrayPool>()),
+      precondition_of_pool(make_shared<array_pool::ArrayPool>()) {
     // Build propositions.
     propositions.resize(task_properties::get_num_facts(task_proxy));
 
@@ -107,7 +109,7 @@ RelaxationHeuristic::RelaxationHeuristic(
     for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
         const auto &precondition_of_vec = precondition_of_vectors[prop_id];
         propositions[prop_id].precondition_of =
-            precondition_of_pool.append(precondition_of_vec);
+            precondition_of_pool->append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
 }
@@ -158,7 +160,7 @@ void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
         vector<PropID> preconditions_copy(precondition_props);
         utils::sort_unique(preconditions_copy);
         array_pool::ArrayPoolIndex precond_index =
-            preconditions_pool.append(preconditions_copy);
+            preconditions_pool->append(preconditions_copy);
         unary_operators.emplace_back(
             preconditions_copy.size(), precond_index, effect_prop,
             op_no, base_cost);
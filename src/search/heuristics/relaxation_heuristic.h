@@ -9,6 +9,7 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <memory>
 #include <vector>
 
 class FactProxy;
@@ -66,12 +67,16 @@ protected:
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
 
-    array_pool::ArrayPool preconditions_pool;
-    array_pool::ArrayPool precondition_of_pool;
+    /*
+      The pools are not modified after construction, so clones of the
+      heuristic share them.
+    */
+    std::shared_ptr<array_pool::ArrayPool> preconditions_pool;
+    std::shared_ptr<array_pool::ArrayPool> precondition_of_pool;
 
     array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
         const UnaryOperator &op = unary_operators[op_id];
-        return preconditions_pool.get_slice(op.preconditions, op.num_preconditions);
+        return preconditions_pool->get_slice(op.preconditions, op.num_preconditions);
     }
 
     // HACK!
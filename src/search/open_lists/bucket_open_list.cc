@@ -0,0 +1,365 @@
+#include "bucket_open_list.h"
+
+#include "../evaluation_result.h"
+#include "../evaluator.h"
+#include "../open_list.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_open_list {
+/*
+  FIFO queue of the entries with the same key. Removed entries are only
+  discarded when they make up at least half of the vector, so the
+  operations take amortized constant time and an emptied bucket keeps
+  its memory for later insertions.
+*/
+template<class Entry>
+class Bucket {
+    static const size_t MIN_DISCARDED_ENTRIES = 64;
+
+    vector<Entry> entries;
+    size_t head;
+public:
+    Bucket() : head(0) {
+    }
+
+    bool empty() const {
+        return head == entries.size();
+    }
+
+    void push(const Entry &entry) {
+        entries.push_back(entry);
+    }
+
+    Entry pop() {
+        assert(!empty());
+        Entry result = entries[head++];
+        if (head == entries.size()) {
+            entries.clear();
+            head = 0;
+        } else if (head >= MIN_DISCARDED_ENTRIES && 2 * head >= entries.size()) {
+            entries.erase(entries.begin(), entries.begin() + head);
+            head = 0;
+        }
+        return result;
+    }
+
+    typename vector<Entry>::const_iterator begin() const {
+        return entries.begin() + head;
+    }
+
+    typename vector<Entry>::const_iterator end() const {
+        return entries.end();
+    }
+};
+
+template<class Entry>
+class BucketOpenList : public OpenList<Entry> {
+    /*
+      The buckets may use more slots than there are insertions as long as
+      their number stays below this bound.
+    */
+    static const int MIN_SLOTS_BEFORE_SWITCH = 1024;
+
+    // Buckets with equal primary key, indexed by the secondary key.
+    struct Row {
+        vector<Bucket<Entry>> buckets;
+        // No bucket below min_key2 contains entries.
+        int min_key2 = 0;
+        int size = 0;
+    };
+
+    struct HeapEntry {
+        int key1;
+        int key2;
+        int64_t order;
+        Entry entry;
+
+        bool operator>(const HeapEntry &other) const {
+            return tie(key1, key2, order) >
+                   tie(other.key1, other.key2, other.order);
+        }
+    };
+
+    vector<Row> rows;
+    // No row below min_key1 contains entries.
+    int min_key1;
+    // Number of rows plus number of buckets in all rows.
+    int64_t num_slots;
+
+    bool use_heap;
+    vector<HeapEntry> heap;
+    int64_t next_order;
+
+    int size;
+    int64_t num_insertions;
+
+    vector<shared_ptr<Evaluator>> evaluators;
+    /*
+      If allow_unsafe_pruning is true, we ignore (don't insert) states
+      which the first evaluator considers a dead end, even if it is
+      not a safe heuristic.
+    */
+    bool allow_unsafe_pruning;
+
+    bool fits_into_buckets(int key1, int key2) const;
+    void switch_to_heap();
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    BucketOpenList(
+        const vector<shared_ptr<Evaluator>> &evals,
+        bool unsafe_pruning, bool pref_only);
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+BucketOpenList<Entry>::BucketOpenList(
+    const vector<shared_ptr<Evaluator>> &evals,
+    bool unsafe_pruning, bool pref_only)
+    : OpenList<Entry>(pref_only),
+      min_key1(0),
+      num_slots(0),
+      use_heap(false),
+      next_order(0),
+      size(0),
+      num_insertions(0),
+      evaluators(evals),
+      allow_unsafe_pruning(unsafe_pruning) {
+    assert(evaluators.size() == 1 || evaluators.size() == 2);
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::fits_into_buckets(int key1, int key2) const {
+    if (key1 < 0 || key2 < 0 ||
+        key1 == EvaluationResult::INFTY || key2 == EvaluationResult::INFTY) {
+        return false;
+    }
+    int64_t new_slots = 0;
+    int num_rows = rows.size();
+    if (key1 >= num_rows) {
+        new_slots += key1 + 1 - num_rows;
+    }
+    int num_buckets = key1 < num_rows ? rows[key1].buckets.size() : 0;
+    if (key2 >= num_buckets) {
+        new_slots += key2 + 1 - num_buckets;
+    }
+    int64_t required_slots = num_slots + new_slots;
+    return new_slots == 0 ||
+           required_slots <= max<int64_t>(MIN_SLOTS_BEFORE_SWITCH,
+                                          num_insertions);
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::switch_to_heap() {
+    assert(!use_heap);
+    // The entries are added in sorted order, which is a valid heap.
+    heap.reserve(size);
+    for (int key1 = min_key1; key1 < static_cast<int>(rows.size()); ++key1) {
+        const Row &row = rows[key1];
+        for (int key2 = row.min_key2;
+             key2 < static_cast<int>(row.buckets.size()); ++key2) {
+            for (const Entry &entry : row.buckets[key2]) {
+                heap.push_back({key1, key2, next_order++, entry});
+            }
+        }
+    }
+    assert(static_cast<int>(heap.size()) == size);
+    vector<Row>().swap(rows);
+    min_key1 = 0;
+    num_slots = 0;
+    use_heap = true;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int key1 = eval_context.get_evaluator_value_or_infinity(
+        evaluators[0].get());
+    int key2 = 0;
+    if (evaluators.size() == 2) {
+        key2 = eval_context.get_evaluator_value_or_infinity(
+            evaluators[1].get());
+    }
+
+    if (!use_heap && !fits_into_buckets(key1, key2)) {
+        switch_to_heap();
+    }
+    if (use_heap) {
+        heap.push_back({key1, key2, next_order++, entry});
+        push_heap(heap.begin(), heap.end(), greater<HeapEntry>());
+    } else {
+        if (key1 >= static_cast<int>(rows.size())) {
+            num_slots += key1 + 1 - rows.size();
+            rows.resize(key1 + 1);
+        }
+        Row &row = rows[key1];
+        if (key2 >= static_cast<int>(row.buckets.size())) {
+            num_slots += key2 + 1 - row.buckets.size();
+            row.buckets.resize(key2 + 1);
+        }
+        row.buckets[key2].push(entry);
+        ++row.size;
+        min_key1 = min(min_key1, key1);
+        row.min_key2 = min(row.min_key2, key2);
+    }
+    ++size;
+    ++num_insertions;
+}
+
+template<class Entry>
+Entry BucketOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    --size;
+    if (use_heap) {
+        pop_heap(heap.begin(), heap.end(), greater<HeapEntry>());
+        Entry result = heap.back().entry;
+        heap.pop_back();
+        return result;
+    }
+    while (rows[min_key1].size == 0) {
+        ++min_key1;
+    }
+    Row &row = rows[min_key1];
+    while (row.buckets[row.min_key2].empty()) {
+        ++row.min_key2;
+    }
+    --row.size;
+    return row.buckets[row.min_key2].pop();
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::clear() {
+    rows.clear();
+    min_key1 = 0;
+    num_slots = 0;
+    use_heap = false;
+    heap.clear();
+    next_order = 0;
+    size = 0;
+    num_insertions = 0;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Same behaviour as in the tie-breaking open list.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    if (allow_unsafe_pruning &&
+        eval_context.is_evaluator_value_infinite(evaluators[0].get()))
+        return true;
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
+            return false;
+    return true;
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    return false;
+}
+
+BucketOpenListFactory::BucketOpenListFactory(
+    const vector<shared_ptr<Evaluator>> &evals,
+    bool unsafe_pruning, bool pref_only)
+    : evals(evals),
+      unsafe_pruning(unsafe_pruning),
+      pref_only(pref_only) {
+}
+
+unique_ptr<StateOpenList>
+BucketOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<StateOpenListEntry>>(
+        evals, unsafe_pruning, pref_only);
+}
+
+unique_ptr<EdgeOpenList>
+BucketOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<EdgeOpenListEntry>>(
+        evals, unsafe_pruning, pref_only);
+}
+
+class BucketOpenListFeature
+    : public plugins::TypedFeature<OpenListFactory, BucketOpenListFactory> {
+public:
+    BucketOpenListFeature() : TypedFeature("bucket") {
+        document_title("Bucket open list");
+        document_synopsis(
+            "Selects the entry with the lexicographically smallest values of "
+            "one or two evaluators and breaks remaining ties in FIFO order, "
+            "like the tie-breaking open list. Entries are stored in arrays "
+            "of buckets indexed by the evaluator values.");
+
+        add_list_option<shared_ptr<Evaluator>>(
+            "evals", "one or two evaluators");
+        add_option<bool>(
+            "unsafe_pruning",
+            "allow unsafe pruning when the main evaluator regards a state a dead end",
+            "true");
+        add_open_list_options_to_feature(*this);
+
+        document_note(
+            "Large values",
+            "If an evaluator value is negative or infinite, or if the "
+            "values span a much larger range than the number of inserted "
+            "entries, the open list switches to a binary heap for all "
+            "entries. The order of the entries does not change.");
+    }
+
+    virtual shared_ptr<BucketOpenListFactory> create_component(
+        const plugins::Options &opts,
+        const utils::Context &context) const override {
+        plugins::verify_list_non_empty<shared_ptr<Evaluator>>(
+            context, opts, "evals");
+        if (opts.get_list<shared_ptr<Evaluator>>("evals").size() > 2) {
+            context.error("bucket open list supports at most two evaluators");
+        }
+        return plugins::make_shared_from_arg_tuples<BucketOpenListFactory>(
+            opts.get_list<shared_ptr<Evaluator>>("evals"),
+            opts.get<bool>("unsafe_pruning"),
+            get_open_list_arguments_from_options(opts)
+            );
+    }
+};
+
+static plugins::FeaturePlugin<BucketOpenListFeature> _plugin;
+}
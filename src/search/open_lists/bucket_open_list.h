@@ -0,0 +1,32 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+
+namespace bucket_open_list {
+/*
+  Open list for one evaluator or a lexicographic pair of evaluators
+  (e.g., [f, h] in A*). It orders entries exactly like the tie-breaking
+  open list with the same evaluators, but stores them in arrays of FIFO
+  buckets indexed directly by the evaluator values.
+
+  If the values are negative, infinite or spread over a range that is
+  large compared to the number of insertions, the open list moves all
+  entries to a binary heap that breaks ties by insertion order and uses
+  the heap until it is cleared.
+*/
+class BucketOpenListFactory : public OpenListFactory {
+    std::vector<std::shared_ptr<Evaluator>> evals;
+    bool unsafe_pruning;
+    bool pref_only;
+public:
+    BucketOpenListFactory(
+        const std::vector<std::shared_ptr<Evaluator>> &evals,
+        bool unsafe_pruning, bool pref_only);
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 #include "pattern_database.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -16,26 +18,52 @@ CanonicalPDBs::CanonicalPDBs(
     : pdbs(pdbs), pattern_cliques(pattern_cliques) {
     assert(pdbs);
     assert(pattern_cliques);
+    rank_terms_begin.reserve(pdbs->size() + 1);
+    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+        rank_terms_begin.push_back(rank_terms.size());
+        const Projection &projection = pdb->get_projection();
+        const Pattern &pattern = projection.get_pattern();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            rank_terms.push_back({pattern[i], projection.get_multiplier(i)});
+        }
+    }
+    rank_terms_begin.push_back(rank_terms.size());
+
+    cliques_begin.reserve(pattern_cliques->size() + 1);
+    for (const PatternClique &clique : *pattern_cliques) {
+        cliques_begin.push_back(clique_pdbs.size());
+        clique_pdbs.insert(clique_pdbs.end(), clique.begin(), clique.end());
+    }
+    cliques_begin.push_back(clique_pdbs.size());
 }
 
 int CanonicalPDBs::get_value(const State &state) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
+    // Reused between calls to avoid allocating memory for every state.
+    static thread_local vector<int> h_values;
+    int num_pdbs = pdbs->size();
+    h_values.resize(num_pdbs);
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
+    const vector<int> &values = state.get_unpacked_values();
+    for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+        int rank = 0;
+        for (int i = rank_terms_begin[pdb_index];
+             i < rank_terms_begin[pdb_index + 1]; ++i) {
+            rank += rank_terms[i].multiplier * values[rank_terms[i].var];
+        }
+        int h = (*pdbs)[pdb_index]->get_value_for_index(rank);
         if (h == numeric_limits<int>::max()) {
             return numeric_limits<int>::max();
         }
-        h_values.push_back(h);
+        h_values[pdb_index] = h;
     }
-    for (const PatternClique &clique : *pattern_cliques) {
+    int max_h = 0;
+    int num_cliques = cliques_begin.size() - 1;
+    for (int clique = 0; clique < num_cliques; ++clique) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (int i = cliques_begin[clique]; i < cliques_begin[clique + 1]; ++i) {
+            clique_h += h_values[clique_pdbs[i]];
         }
         max_h = max(max_h, clique_h);
     }
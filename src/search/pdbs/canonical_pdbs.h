@@ -4,14 +4,35 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
 namespace pdbs {
+/*
+  Canonical heuristic over a PDB collection: the maximum over the pattern
+  cliques of the sum of the PDB values in the clique.
+
+  For evaluation, the constructor copies the ranking data of all PDBs
+  (pattern variables and multipliers) and the cliques into flat arrays, so
+  that computing all PDB values for a state is a single pass over
+  contiguous memory, followed by one pass over the cliques.
+*/
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    struct RankTerm {
+        int var;
+        int multiplier;
+    };
+    // The terms for PDB i are rank_terms[rank_terms_begin[i], rank_terms_begin[i + 1]).
+    std::vector<RankTerm> rank_terms;
+    std::vector<int> rank_terms_begin;
+    // The PDBs of clique i are clique_pdbs[cliques_begin[i], cliques_begin[i + 1]).
+    std::vector<int> clique_pdbs;
+    std::vector<int> cliques_begin;
+
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
@@ -71,6 +71,11 @@ CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(
               task, patterns, max_time_dominance_pruning, log)) {
 }
 
+shared_ptr<Evaluator> CanonicalPDBsHeuristic::clone_for_worker() const {
+    // The pattern databases are shared.
+    return make_shared<CanonicalPDBsHeuristic>(*this);
+}
+
 int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int h = canonical_pdbs.get_value(state);
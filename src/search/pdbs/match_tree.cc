@@ -1,5 +1,6 @@
 #include "match_tree.h"
 
+#include "abstract_operator.h"
 #include "pattern_database.h"
 
 #include "../utils/logging.h"
@@ -11,79 +12,62 @@
 using namespace std;
 
 namespace pdbs {
-struct MatchTree::Node {
-    static const int LEAF_NODE = -1;
-    Node();
-    ~Node();
+/*
+  Pointer-based node of the match tree while it is built. Only used in the
+  constructor, which converts the tree to the flat representation.
+*/
+struct MatchTree::BuilderNode {
     vector<int> applicable_operator_ids;
     // The variable which this node represents.
     int var_id;
-    int var_domain_size;
     /*
       Each node has one outgoing edge for each possible value of the variable
       and one "star-edge" that is used when the value of the variable is
       undefined.
     */
-    Node **successors;
-    Node *star_successor;
+    vector<unique_ptr<BuilderNode>> successors;
+    unique_ptr<BuilderNode> star_successor;
 
-    void initialize(int var_id, int var_domain_size);
-    bool is_leaf_node() const;
-};
-
-MatchTree::Node::Node()
-    : var_id(LEAF_NODE),
-      var_domain_size(0),
-      successors(nullptr),
-      star_successor(nullptr) {
-}
-
-MatchTree::Node::~Node() {
-    if (successors) {
-        for (int i = 0; i < var_domain_size; ++i) {
-            delete successors[i];
-        }
-        delete[] successors;
+    BuilderNode()
+        : var_id(LEAF_NODE) {
     }
-    delete star_successor;
-}
 
-void MatchTree::Node::initialize(int var_id_, int var_domain_size_) {
-    assert(is_leaf_node());
-    assert(var_id_ >= 0);
-    var_id = var_id_;
-    var_domain_size = var_domain_size_;
-    if (var_domain_size > 0) {
-        successors = new Node *[var_domain_size];
-        for (int val = 0; val < var_domain_size; ++val) {
-            successors[val] = nullptr;
-        }
+    void initialize(int var_id_, int var_domain_size) {
+        assert(is_leaf_node());
+        assert(var_id_ >= 0);
+        var_id = var_id_;
+        successors.resize(var_domain_size);
     }
-}
-
-bool MatchTree::Node::is_leaf_node() const {
-    return var_id == LEAF_NODE;
-}
 
-MatchTree::MatchTree(const TaskProxy &task_proxy, const Projection &projection)
-    : task_proxy(task_proxy),
-      projection(projection),
-      root(nullptr) {
-}
+    bool is_leaf_node() const {
+        return var_id == LEAF_NODE;
+    }
+};
 
-MatchTree::~MatchTree() {
-    delete root;
+MatchTree::MatchTree(
+    const TaskProxy &task_proxy, const Projection &projection,
+    const vector<AbstractOperator> &abstract_ops) {
+    unique_ptr<BuilderNode> root;
+    for (size_t op_id = 0; op_id < abstract_ops.size(); ++op_id) {
+        const AbstractOperator &op = abstract_ops[op_id];
+        insert_recursive(task_proxy, projection, op_id,
+                         op.get_regression_preconditions(), 0, root);
+    }
+    if (root) {
+        flatten(projection, *root, NO_NODE);
+    }
 }
 
 void MatchTree::insert_recursive(
+    const TaskProxy &task_proxy, const Projection &projection,
     int op_id, const vector<FactPair> &regression_preconditions,
-    int pre_index, Node **edge_from_parent) {
-    if (*edge_from_parent == nullptr) {
+    int pre_index, unique_ptr<BuilderNode> &edge_from_parent) {
+    if (!edge_from_parent) {
         // We don't exist yet: create a new node.
-        *edge_from_parent = new Node();
+        edge_from_parent = make_unique<BuilderNode>();
     }
 
-    Node *node = *edge_from_parent;
+    BuilderNode *node = edge_from_parent.get();
     if (pre_index == static_cast<int>(regression_preconditions.size())) {
         // All preconditions have been checked, insert operator ID.
         node->applicable_operator_ids.push_back(op_id);
@@ -100,18 +84,18 @@ void MatchTree::insert_recursive(
         } else if (node->var_id > pattern_var_id) {
             /* The variable to test has been left out: must insert new
                node and treat it as the "node". */
-            Node *new_node = new Node();
+            unique_ptr<BuilderNode> new_node = make_unique<BuilderNode>();
             new_node->initialize(pattern_var_id, var_domain_size);
             // The new node gets the left out variable as its variable.
-            *edge_from_parent = new_node;
-            new_node->star_successor = node;
+            new_node->star_successor = move(edge_from_parent);
+            edge_from_parent = move(new_node);
             // The new node is now the node of interest.
-            node = new_node;
+            node = edge_from_parent.get();
         }
 
         /* Set up edge to the correct child (for which we want to call
            this function recursively). */
-        Node **edge_to_child = nullptr;
+        unique_ptr<BuilderNode> *edge_to_child = nullptr;
         if (node->var_id == fact.var) {
             // Operator has a precondition on the variable tested by node.
             edge_to_child = &node->successors[fact.value];
@@ -123,95 +107,92 @@ void MatchTree::insert_recursive(
             edge_to_child = &node->star_successor;
         }
 
-        insert_recursive(op_id, regression_preconditions, pre_index, edge_to_child);
+        insert_recursive(task_proxy, projection, op_id,
+                         regression_preconditions, pre_index, *edge_to_child);
     }
 }
 
-void MatchTree::insert(int op_id, const vector<FactPair> &regression_preconditions) {
-    insert_recursive(op_id, regression_preconditions, 0, &root);
-}
-
-void MatchTree::get_applicable_operator_ids_recursive(
-    Node *node, int state_index, vector<int> &operator_ids) const {
-    /*
-      Note: different from the code that builds the match tree, we do
-      the test if node == 0 *before* calling traverse rather than *at
-      the start* of traverse since this turned out to be faster in
-      some informal experiments.
-     */
-
+int MatchTree::flatten(
+    const Projection &projection, const BuilderNode &builder_node,
+    int continuation) {
+    int node_id = nodes.size();
+    nodes.emplace_back();
+    Node node;
+    node.var_id = builder_node.var_id;
+    node.operators_begin = operator_ids.size();
     operator_ids.insert(operator_ids.end(),
-                        node->applicable_operator_ids.begin(),
-                        node->applicable_operator_ids.end());
-
-    if (node->is_leaf_node())
-        return;
-
-    int val = projection.unrank(state_index, node->var_id);
-
-    if (node->successors[val]) {
-        // Follow the correct successor edge, if it exists.
-        get_applicable_operator_ids_recursive(
-            node->successors[val], state_index, operator_ids);
-    }
-    if (node->star_successor) {
-        // Always follow the star edge, if it exists.
-        get_applicable_operator_ids_recursive(
-            node->star_successor, state_index, operator_ids);
+                        builder_node.applicable_operator_ids.begin(),
+                        builder_node.applicable_operator_ids.end());
+    node.operators_end = operator_ids.size();
+    if (builder_node.is_leaf_node()) {
+        node.multiplier = 0;
+        node.domain_size = 0;
+        node.successors_begin = 0;
+        node.next = continuation;
+    } else {
+        node.multiplier = projection.get_multiplier(node.var_id);
+        node.domain_size = builder_node.successors.size();
+        /*
+          The traversal continues with the star successor after the subtree
+          of the successor for the value of the variable.
+        */
+        if (builder_node.star_successor) {
+            node.next = flatten(
+                projection, *builder_node.star_successor, continuation);
+        } else {
+            node.next = continuation;
+        }
+        node.successors_begin = successors.size();
+        successors.resize(successors.size() + node.domain_size, NO_NODE);
+        for (int val = 0; val < node.domain_size; ++val) {
+            if (builder_node.successors[val]) {
+                successors[node.successors_begin + val] = flatten(
+                    projection, *builder_node.successors[val], node.next);
+            }
+        }
     }
+    nodes[node_id] = node;
+    return node_id;
 }
 
 void MatchTree::get_applicable_operator_ids(
-    int state_index, vector<int> &operator_ids) const {
-    if (root)
-        get_applicable_operator_ids_recursive(root, state_index, operator_ids);
+    int state_index, vector<int> &applicable_operator_ids) const {
+    for_each_applicable_operator_id(
+        state_index, [&](int op_id) {
+            applicable_operator_ids.push_back(op_id);
+        });
 }
 
-void MatchTree::dump_recursive(Node *node, utils::LogProxy &log) const {
+void MatchTree::dump(utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
-        if (!node) {
-            // Node is the root node.
+        if (nodes.empty()) {
             log << "Empty MatchTree" << endl;
             return;
         }
-        log << endl;
-        log << "node->var_id = " << node->var_id << endl;
-        log << "Number of applicable operators at this node: "
-            << node->applicable_operator_ids.size() << endl;
-        for (int op_id : node->applicable_operator_ids) {
-            log << "AbstractOperator #" << op_id << endl;
-        }
-        if (node->is_leaf_node()) {
-            log << "leaf node." << endl;
-            assert(!node->successors);
-            assert(!node->star_successor);
-        } else {
-            for (int val = 0; val < node->var_domain_size; ++val) {
-                if (node->successors[val]) {
-                    log << "recursive call for child with value " << val << endl;
-                    dump_recursive(node->successors[val], log);
-                    log << "back from recursive call (for successors[" << val
-                        << "]) to node with var_id = " << node->var_id
-                        << endl;
-                } else {
-                    log << "no child for value " << val << endl;
-                }
+        for (size_t node_id = 0; node_id < nodes.size(); ++node_id) {
+            const Node &node = nodes[node_id];
+            log << endl;
+            log << "node #" << node_id << ", var_id = " << node.var_id << endl;
+            log << "Number of applicable operators at this node: "
+                << node.operators_end - node.operators_begin << endl;
+            for (int i = node.operators_begin; i < node.operators_end; ++i) {
+                log << "AbstractOperator #" << operator_ids[i] << endl;
             }
-            if (node->star_successor) {
-                log << "recursive call for star_successor" << endl;
-                dump_recursive(node->star_successor, log);
-                log << "back from recursive call (for star_successor) "
-                    << "to node with var_id = " << node->var_id << endl;
+            if (node.is_leaf_node()) {
+                log << "leaf node." << endl;
             } else {
-                log << "no star_successor" << endl;
+                for (int val = 0; val < node.domain_size; ++val) {
+                    int successor = successors[node.successors_begin + val];
+                    if (successor != NO_NODE) {
+                        log << "child for value " << val << ": node #"
+                            << successor << endl;
+                    } else {
+                        log << "no child for value " << val << endl;
+                    }
+                }
             }
+            log << "next node: " << node.next << endl;
         }
     }
 }
-
-void MatchTree::dump(utils::LogProxy &log) const {
-    if (log.is_at_least_debug()) {
-        dump_recursive(root, log);
-    }
-}
 }
@@ -3,11 +3,10 @@
 
 #include "types.h"
 
-#include "pattern_database.h"
-
 #include "../task_proxy.h"
 
-#include <cstddef>
+#include <cassert>
+#include <memory>
 #include <vector>
 
 namespace utils {
@@ -15,39 +14,87 @@ class LogProxy;
 }
 
 namespace pdbs {
+class AbstractOperator;
 class Projection;
 
 /*
   Successor Generator for abstract operators.
 
-  NOTE: MatchTree keeps a reference to the task proxy passed to the constructor.
-  Therefore, users of the class must ensure that the task lives at least as long
-  as the match tree.
+  The tree is built from the regression preconditions of the abstract
+  operators and then stored in flat arrays. A query visits a node, then
+  follows the successor edge for the value of the node's variable if there
+  is one and otherwise jumps to the next node: the star successor of the
+  node or, if there is none, the node where the traversal continues after
+  the subtree of the node. Since every node has a unique parent, these
+  jumps are fixed, so queries need neither recursion nor a stack.
 */
-
 class MatchTree {
-    TaskProxy task_proxy;
-    Projection projection;
-    struct Node;
-    Node *root;
-    void insert_recursive(int op_id,
-                          const std::vector<FactPair> &regression_preconditions,
-                          int pre_index,
-                          Node **edge_from_parent);
-    void get_applicable_operator_ids_recursive(
-        Node *node, int state_index, std::vector<int> &operator_ids) const;
-    void dump_recursive(Node *node, utils::LogProxy &log) const;
+    static const int NO_NODE = -1;
+    static const int LEAF_NODE = -1;
+
+    struct Node {
+        // The pattern variable which this node tests or LEAF_NODE.
+        int var_id;
+        // Multiplier and domain size of var_id, for unranking.
+        int multiplier;
+        int domain_size;
+        // Index of the first of domain_size successors in successors.
+        int successors_begin;
+        /*
+          Node where the traversal continues if there is no successor for
+          the value of var_id: the star successor of this node or, if there
+          is none, the node after this subtree.
+        */
+        int next;
+        // Range of the IDs of the operators of this node in operator_ids.
+        int operators_begin;
+        int operators_end;
+
+        bool is_leaf_node() const {
+            return var_id == LEAF_NODE;
+        }
+    };
+
+    struct BuilderNode;
+
+    std::vector<Node> nodes;
+    std::vector<int> successors;
+    std::vector<int> operator_ids;
+
+    void insert_recursive(
+        const TaskProxy &task_proxy, const Projection &projection,
+        int op_id, const std::vector<FactPair> &regression_preconditions,
+        int pre_index, std::unique_ptr<BuilderNode> &edge_from_parent);
+    int flatten(
+        const Projection &projection, const BuilderNode &builder_node,
+        int continuation);
 public:
+    MatchTree(const TaskProxy &task_proxy, const Projection &projection,
+              const std::vector<AbstractOperator> &abstract_ops);
+
     /*
-      Initialize an empty match tree. We copy projection to ensure that the
-      match tree remains in a valid state independently of projection.
+      Call callback(op_id) for the IDs of all abstract operators that are
+      applicable in regression in the abstract state given by state_index.
     */
-    MatchTree(const TaskProxy &task_proxy,
-              const Projection &projection);
-    ~MatchTree();
-    /* Insert an abstract operator into the match tree, creating or
-       enlarging it. */
-    void insert(int op_id, const std::vector<FactPair> &regression_preconditions);
+    template<typename Callback>
+    void for_each_applicable_operator_id(
+        int state_index, const Callback &callback) const {
+        int node_id = nodes.empty() ? NO_NODE : 0;
+        while (node_id != NO_NODE) {
+            assert(node_id < static_cast<int>(nodes.size()));
+            const Node &node = nodes[node_id];
+            for (int i = node.operators_begin; i < node.operators_end; ++i) {
+                callback(operator_ids[i]);
+            }
+            if (node.is_leaf_node()) {
+                node_id = node.next;
+            } else {
+                int val = state_index / node.multiplier % node.domain_size;
+                int successor = successors[node.successors_begin + val];
+                node_id = (successor == NO_NODE) ? node.next : successor;
+            }
+        }
+    }
 
     /*
       Extracts all IDs of applicable abstract operators for the abstract state
@@ -55,7 +102,7 @@ public:
       pairs).
     */
     void get_applicable_operator_ids(
-        int state_index, std::vector<int> &operator_ids) const;
+        int state_index, std::vector<int> &applicable_operator_ids) const;
     void dump(utils::LogProxy &log) const;
 };
 }
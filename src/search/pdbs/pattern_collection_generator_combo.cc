@@ -18,8 +18,8 @@ using namespace std;
 
 namespace pdbs {
 PatternCollectionGeneratorCombo::PatternCollectionGeneratorCombo(
-    int max_states, utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int max_states, int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       max_states(max_states),
       verbosity(verbosity) {
 }
@@ -59,7 +59,7 @@ public:
             "maximum abstraction size for combo strategy",
             "1000000",
             plugins::Bounds("1", "infinity"));
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 
     virtual shared_ptr<PatternCollectionGeneratorCombo> create_component(
@@ -67,7 +67,7 @@ public:
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<PatternCollectionGeneratorCombo>(
             opts.get<int>("max_states"),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
@@ -13,8 +13,8 @@ namespace pdbs {
 PatternCollectionGeneratorDisjointCegar::PatternCollectionGeneratorDisjointCegar(
     int max_pdb_size, int max_collection_size, double max_time,
     bool use_wildcard_plans, int random_seed,
-    utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       max_pdb_size(max_pdb_size),
       max_collection_size(max_collection_size),
       max_time(max_time),
@@ -79,7 +79,7 @@ public:
             plugins::Bounds("0.0", "infinity"));
         add_cegar_wildcard_option_to_feature(*this);
         utils::add_rng_options_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
 
         add_cegar_implementation_notes_to_feature(*this);
     }
@@ -93,7 +93,7 @@ public:
             opts.get<double>("max_time"),
             get_cegar_wildcard_arguments_from_options(opts),
             utils::get_rng_arguments_from_options(opts),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
@@ -26,7 +26,7 @@ public:
     PatternCollectionGeneratorDisjointCegar(
         int max_pdb_size, int max_collection_size, double max_time,
         bool use_wildcard_plans, int random_seed,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 }
 
@@ -27,8 +27,8 @@ namespace pdbs {
 PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
     int pdb_max_size, int num_collections, int num_episodes,
     double mutation_probability, bool disjoint, int random_seed,
-    utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       pdb_max_size(pdb_max_size),
       num_collections(num_collections),
       num_episodes(num_episodes),
@@ -348,7 +348,7 @@ public:
             "fitness) if its patterns are not disjoint",
             "false");
         utils::add_rng_options_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
 
         document_note(
             "Note",
@@ -401,7 +401,7 @@ public:
             opts.get<double>("mutation_probability"),
             opts.get<bool>("disjoint"),
             utils::get_rng_arguments_from_options(opts),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
@@ -116,7 +116,7 @@ public:
     PatternCollectionGeneratorGenetic(
         int pdb_max_size, int num_collections, int num_episodes,
         double mutation_probability, bool disjoint, int random_seed,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 }
 
@@ -115,8 +115,8 @@ static vector<vector<int>> compute_relevant_neighbours(const TaskProxy &task_pro
 PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(
     int pdb_max_size, int collection_max_size, int num_samples,
     int min_improvement, double max_time, int random_seed,
-    utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       pdb_max_size(pdb_max_size),
       collection_max_size(collection_max_size),
       num_samples(num_samples),
@@ -135,7 +135,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -162,16 +162,21 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        compute_pdb(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    // The new PDBs are independent of each other, so we compute them together.
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb :
+         compute_pdbs(task_proxy, new_patterns, num_threads)) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -611,7 +616,7 @@ public:
             "optimized for the Evaluator#Canonical_PDB heuristic. It it described "
             "in the following paper:" + paper_references());
         add_hillclimbing_options_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 
     virtual shared_ptr<PatternCollectionGeneratorHillclimbing>
@@ -620,7 +625,7 @@ public:
         check_hillclimbing_options(opts, context);
         return plugins::make_shared_from_arg_tuples<PatternCollectionGeneratorHillclimbing>(
             get_hillclimbing_arguments_from_options(opts),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
@@ -645,6 +650,7 @@ public:
             "PatternCollectionGenerator#Hill_climbing for more details.");
 
         add_hillclimbing_options_to_feature(*this);
+        add_num_threads_option_to_feature(*this);
         /*
           Add, possibly among others, the options for dominance pruning.
           Note that using dominance pruning during hill climbing could lead to fewer
@@ -673,6 +679,7 @@ public:
         shared_ptr<PatternCollectionGeneratorHillclimbing> pgh =
             plugins::make_shared_from_arg_tuples<PatternCollectionGeneratorHillclimbing>(
                 get_hillclimbing_arguments_from_options(opts),
+                opts.get<int>("num_threads"),
                 get_generator_arguments_from_options(opts)
                 );
 
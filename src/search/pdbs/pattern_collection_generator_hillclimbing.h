@@ -135,7 +135,7 @@ public:
     PatternCollectionGeneratorHillclimbing(
         int pdb_max_size, int collection_max_size, int num_samples,
         int min_improvement, double max_time, int random_seed,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 
 extern void add_hillclimbing_options_to_feature(
@@ -13,8 +13,9 @@ using namespace std;
 
 namespace pdbs {
 PatternCollectionGeneratorManual::PatternCollectionGeneratorManual(
-    const vector<Pattern> &patterns, utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    const vector<Pattern> &patterns, int num_threads,
+    utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       patterns(make_shared<PatternCollection>(patterns)) {
 }
 
@@ -39,7 +40,7 @@ public:
             "patterns",
             "list of patterns (which are lists of variable numbers of the planning "
             "task).");
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 
     virtual shared_ptr<PatternCollectionGeneratorManual>
@@ -48,7 +49,7 @@ public:
         const utils::Context &) const override {
         return plugins::make_shared_from_arg_tuples<PatternCollectionGeneratorManual>(
             opts.get_list<Pattern>("patterns"),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
@@ -16,7 +16,7 @@ class PatternCollectionGeneratorManual : public PatternCollectionGenerator {
 public:
     explicit PatternCollectionGeneratorManual(
         const std::vector<Pattern> &patterns,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 }
 
@@ -20,8 +20,8 @@ PatternCollectionGeneratorMultiple::PatternCollectionGeneratorMultiple(
     double pattern_generation_max_time, double total_max_time,
     double stagnation_limit, double blacklist_trigger_percentage,
     bool enable_blacklist_on_stagnation, int random_seed,
-    utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       max_pdb_size(max_pdb_size),
       pattern_generation_max_time(pattern_generation_max_time),
       total_max_time(total_max_time),
@@ -328,11 +328,11 @@ void add_multiple_options_to_feature(plugins::Feature &feature) {
         "hit.",
         "true");
     utils::add_rng_options_to_feature(feature);
-    add_generator_options_to_feature(feature);
+    add_collection_generator_options_to_feature(feature);
 }
 
 tuple<int, int, double, double, double, double, bool, int,
-      utils::Verbosity>
+      int, utils::Verbosity>
 get_multiple_arguments_from_options(const plugins::Options &opts) {
     return tuple_cat(
         make_tuple(
@@ -344,6 +344,6 @@ get_multiple_arguments_from_options(const plugins::Options &opts) {
             opts.get<double>("blacklist_trigger_percentage"),
             opts.get<bool>("enable_blacklist_on_stagnation")),
         utils::get_rng_arguments_from_options(opts),
-        get_generator_arguments_from_options(opts));
+        get_collection_generator_arguments_from_options(opts));
 }
 }
@@ -15,12 +15,12 @@ PatternCollectionGeneratorMultipleCegar::PatternCollectionGeneratorMultipleCegar
     double pattern_generation_max_time, double total_max_time,
     double stagnation_limit, double blacklist_trigger_percentage,
     bool enable_blacklist_on_stagnation, int random_seed,
-    utils::Verbosity verbosity)
+    int num_threads, utils::Verbosity verbosity)
     : PatternCollectionGeneratorMultiple(
           max_pdb_size, max_collection_size,
           pattern_generation_max_time, total_max_time, stagnation_limit,
           blacklist_trigger_percentage, enable_blacklist_on_stagnation,
-          random_seed, verbosity),
+          random_seed, num_threads, verbosity),
       use_wildcard_plans(use_wildcard_plans) {
 }
 
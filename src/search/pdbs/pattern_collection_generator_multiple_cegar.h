@@ -23,7 +23,7 @@ public:
         double total_max_time, double stagnation_limit,
         double blacklist_trigger_percentage,
         bool enable_blacklist_on_stagnation, int random_seed,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 }
 
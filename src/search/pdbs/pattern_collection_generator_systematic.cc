@@ -48,8 +48,8 @@ static void compute_union_pattern(
 
 PatternCollectionGeneratorSystematic::PatternCollectionGeneratorSystematic(
     int pattern_max_size, bool only_interesting_patterns,
-    utils::Verbosity verbosity)
-    : PatternCollectionGenerator(verbosity),
+    int num_threads, utils::Verbosity verbosity)
+    : PatternCollectionGenerator(num_threads, verbosity),
       max_pattern_size(pattern_max_size),
       only_interesting_patterns(only_interesting_patterns) {
 }
@@ -313,7 +313,7 @@ public:
             "Only consider the union of two disjoint patterns if the union has "
             "more information than the individual patterns.",
             "true");
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 
     virtual shared_ptr<PatternCollectionGeneratorSystematic>
@@ -323,7 +323,7 @@ public:
         return plugins::make_shared_from_arg_tuples<PatternCollectionGeneratorSystematic>(
             opts.get<int>("pattern_max_size"),
             opts.get<bool>("only_interesting_patterns"),
-            get_generator_arguments_from_options(opts)
+            get_collection_generator_arguments_from_options(opts)
             );
     }
 };
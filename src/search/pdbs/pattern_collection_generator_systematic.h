@@ -46,7 +46,7 @@ class PatternCollectionGeneratorSystematic : public PatternCollectionGenerator {
 public:
     PatternCollectionGeneratorSystematic(
         int pattern_max_size, bool only_interesting_patterns,
-        utils::Verbosity verbosity);
+        int num_threads, utils::Verbosity verbosity);
 };
 }
 
@@ -24,6 +24,7 @@ PatternCollectionInformation::PatternCollectionInformation(
       patterns(patterns),
       pdbs(nullptr),
       pattern_cliques(nullptr),
+      num_threads(1),
       log(log) {
     assert(patterns);
     validate_and_normalize_patterns(task_proxy, *patterns, log);
@@ -63,12 +64,8 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
         if (log.is_at_least_normal()) {
             log << "Computing PDBs for pattern collection..." << endl;
         }
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                compute_pdb(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = make_shared<PDBCollection>(
+            compute_pdbs(task_proxy, *patterns, num_threads));
         if (log.is_at_least_normal()) {
             log << "Done computing PDBs for pattern collection: "
                 << timer << endl;
@@ -102,6 +99,11 @@ void PatternCollectionInformation::set_pattern_cliques(
     assert(information_is_valid());
 }
 
+void PatternCollectionInformation::set_num_threads(int num_threads_) {
+    assert(num_threads_ >= 0);
+    num_threads = num_threads_;
+}
+
 shared_ptr<PatternCollection> PatternCollectionInformation::get_patterns() const {
     assert(patterns);
     return patterns;
@@ -29,6 +29,8 @@ class PatternCollectionInformation {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Number of threads for computing missing PDBs.
+    int num_threads;
     utils::LogProxy &log;
 
     void create_pdbs_if_missing();
@@ -45,6 +47,7 @@ public:
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
     void set_pattern_cliques(
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
+    void set_num_threads(int num_threads);
 
     TaskProxy get_task_proxy() const {
         return task_proxy;
@@ -2,10 +2,14 @@
 
 #include "../task_utils/task_properties.h"
 
+#include "../utils/collections.h"
+#include "../utils/disk_cache.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <vector>
@@ -56,21 +60,55 @@ int Projection::unrank(int index, int var) const {
 
 PatternDatabase::PatternDatabase(
     Projection &&projection,
-    vector<int> &&distances)
+    vector<int> &&distances_)
+    : projection(move(projection)) {
+    int max_finite_value = 0;
+    for (int value : distances_) {
+        if (value != numeric_limits<int>::max()) {
+            max_finite_value = max(max_finite_value, value);
+        }
+    }
+    // The largest value of each type is reserved for dead-ends.
+    if (max_finite_value < numeric_limits<uint8_t>::max()) {
+        store_distances<uint8_t>(distances_);
+    } else if (max_finite_value < numeric_limits<uint16_t>::max()) {
+        store_distances<uint16_t>(distances_);
+    } else {
+        store_distances<int>(distances_);
+    }
+    utils::release_vector_memory(distances_);
+}
+
+PatternDatabase::PatternDatabase(
+    Projection &&projection,
+    const shared_ptr<const utils::MappedFile> &mapped_file,
+    const uint8_t *distances, int bytes_per_value)
     : projection(move(projection)),
-      distances(move(distances)) {
+      distances(distances),
+      bytes_per_value(bytes_per_value),
+      mapped_file(mapped_file) {
+    assert(bytes_per_value == 1 || bytes_per_value == 2 || bytes_per_value == 4);
 }
 
-int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[projection.rank(state)];
+template<typename Value>
+void PatternDatabase::store_distances(const vector<int> &values) {
+    bytes_per_value = sizeof(Value);
+    owned_distances.resize(values.size() * sizeof(Value));
+    for (size_t i = 0; i < values.size(); ++i) {
+        Value value = (values[i] == numeric_limits<int>::max())
+            ? numeric_limits<Value>::max() : values[i];
+        memcpy(&owned_distances[i * sizeof(Value)], &value, sizeof(Value));
+    }
+    distances = owned_distances.data();
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int i = 0; i < get_size(); ++i) {
+        int h = get_value_for_index(i);
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
             ++size;
         }
     }
@@ -5,8 +5,16 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <vector>
 
+namespace utils {
+class MappedFile;
+}
+
 namespace pdbs {
 class Projection {
     Pattern pattern;
@@ -42,25 +50,84 @@ class PatternDatabase {
     Projection projection;
 
     /*
-      final h-values for abstract-states.
-      dead-ends are represented by numeric_limits<int>::max()
+      final h-values for abstract-states, stored with bytes_per_value bytes
+      (1, 2 or 4) per state. The width is the smallest one that can hold
+      the largest finite h-value. Dead-ends are represented by the largest
+      value of the type, which get_value() maps to numeric_limits<int>::max().
     */
-    std::vector<int> distances;
+    const std::uint8_t *distances;
+    int bytes_per_value;
+    // Memory of distances for computed PDBs.
+    std::vector<std::uint8_t> owned_distances;
+    // Memory of distances for PDBs loaded from a file.
+    std::shared_ptr<const utils::MappedFile> mapped_file;
+
+    template<typename Value>
+    void store_distances(const std::vector<int> &values);
+
+    template<typename Value>
+    int get_stored_value(int index) const {
+        Value value;
+        std::memcpy(&value, distances + index * sizeof(Value), sizeof(Value));
+        if (value == std::numeric_limits<Value>::max()) {
+            return std::numeric_limits<int>::max();
+        }
+        return value;
+    }
 public:
     PatternDatabase(
         Projection &&projection,
         std::vector<int> &&distances);
-    int get_value(const std::vector<int> &state) const;
+    /*
+      Use distances that are stored in the given file in the format of
+      get_stored_distances(), with the given number of bytes per value.
+    */
+    PatternDatabase(
+        Projection &&projection,
+        const std::shared_ptr<const utils::MappedFile> &mapped_file,
+        const std::uint8_t *distances, int bytes_per_value);
+
+    PatternDatabase(const PatternDatabase &) = delete;
+    PatternDatabase &operator=(const PatternDatabase &) = delete;
+
+    int get_value(const std::vector<int> &state) const {
+        return get_value_for_index(projection.rank(state));
+    }
+
+    // Return the h-value of the abstract state with the given index (rank).
+    int get_value_for_index(int index) const {
+        switch (bytes_per_value) {
+        case 1:
+            return get_stored_value<std::uint8_t>(index);
+        case 2:
+            return get_stored_value<std::uint16_t>(index);
+        default:
+            return get_stored_value<int>(index);
+        }
+    }
 
     const Pattern &get_pattern() const {
         return projection.get_pattern();
     }
 
+    const Projection &get_projection() const {
+        return projection;
+    }
+
     // The size of the PDB is the number of abstract states.
     int get_size() const {
         return projection.get_num_abstract_states();
     }
 
+    int get_bytes_per_value() const {
+        return bytes_per_value;
+    }
+
+    // Return the stored h-values (get_size() * get_bytes_per_value() bytes).
+    const std::uint8_t *get_stored_distances() const {
+        return distances;
+    }
+
     /*
       Return the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
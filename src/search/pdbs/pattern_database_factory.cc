@@ -3,15 +3,21 @@
 #include "abstract_operator.h"
 #include "match_tree.h"
 #include "pattern_database.h"
+#include "pdb_cache.h"
+#include "utils.h"
 
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/disk_cache.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <limits>
+#include <numeric>
 #include <vector>
 
 using namespace std;
@@ -91,6 +97,16 @@ class PatternDatabaseFactory {
     */
     bool is_goal_state(int state_index) const;
 
+    /*
+      Relax all abstract operators that are applicable in regression in the
+      given state and call improved(predecessor, distance) for every
+      predecessor state whose goal distance decreases.
+    */
+    template<typename Callback>
+    void relax_regression_operators(
+        const MatchTree &match_tree, int state_index, bool compute_plan,
+        const Callback &improved);
+
     void compute_distances(const MatchTree &match_tree, bool compute_plan);
 
     void compute_plan(
@@ -263,12 +279,7 @@ void PatternDatabaseFactory::compute_abstract_operators(
 }
 
 unique_ptr<MatchTree> PatternDatabaseFactory::compute_match_tree() const {
-    unique_ptr<MatchTree> match_tree = utils::make_unique_ptr<MatchTree>(task_proxy, projection);
-    for (size_t op_id = 0; op_id < abstract_ops.size(); ++op_id) {
-        const AbstractOperator &op = abstract_ops[op_id];
-        match_tree->insert(op_id, op.get_regression_preconditions());
-    }
-    return match_tree;
+    return utils::make_unique_ptr<MatchTree>(task_proxy, projection, abstract_ops);
 }
 
 void PatternDatabaseFactory::compute_abstract_goals() {
@@ -292,16 +303,33 @@ bool PatternDatabaseFactory::is_goal_state(int state_index) const {
     return true;
 }
 
+template<typename Callback>
+void PatternDatabaseFactory::relax_regression_operators(
+    const MatchTree &match_tree, int state_index, bool compute_plan,
+    const Callback &improved) {
+    int distance = distances[state_index];
+    match_tree.for_each_applicable_operator_id(
+        state_index, [&](int op_id) {
+            const AbstractOperator &op = abstract_ops[op_id];
+            int predecessor = state_index + op.get_hash_effect();
+            int alternative_cost = distance + op.get_cost();
+            if (alternative_cost < distances[predecessor]) {
+                distances[predecessor] = alternative_cost;
+                if (compute_plan) {
+                    generating_op_ids[predecessor] = op_id;
+                }
+                improved(predecessor, alternative_cost);
+            }
+        });
+}
+
 void PatternDatabaseFactory::compute_distances(
     const MatchTree &match_tree, bool compute_plan) {
     distances.reserve(projection.get_num_abstract_states());
-    // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<int> pq;
-
-    // initialize queue
+    vector<int> goal_states;
     for (int state_index = 0; state_index < projection.get_num_abstract_states(); ++state_index) {
         if (is_goal_state(state_index)) {
-            pq.push(0, state_index);
+            goal_states.push_back(state_index);
             distances.push_back(0);
         } else {
             distances.push_back(numeric_limits<int>::max());
@@ -322,6 +350,38 @@ void PatternDatabaseFactory::compute_distances(
         generating_op_ids.resize(projection.get_num_abstract_states());
     }
 
+    bool uniform_costs = all_of(
+        abstract_ops.begin(), abstract_ops.end(),
+        [&](const AbstractOperator &op) {
+            return op.get_cost() == abstract_ops[0].get_cost();
+        });
+    if (uniform_costs) {
+        /*
+          If all operators have the same cost, states are reached in the
+          order of their goal distances, so we use breadth-first search.
+          Every state is reached (and queued) only once.
+        */
+        deque<int> queue(goal_states.begin(), goal_states.end());
+        utils::release_vector_memory(goal_states);
+        while (!queue.empty()) {
+            int state_index = queue.front();
+            queue.pop_front();
+            relax_regression_operators(
+                match_tree, state_index, compute_plan,
+                [&](int predecessor, int) {
+                    queue.push_back(predecessor);
+                });
+        }
+        return;
+    }
+
+    // first implicit entry: priority, second entry: index for an abstract state
+    priority_queues::AdaptiveQueue<int> pq;
+    for (int state_index : goal_states) {
+        pq.push(0, state_index);
+    }
+    utils::release_vector_memory(goal_states);
+
     // Dijkstra loop
     while (!pq.empty()) {
         pair<int, int> node = pq.pop();
@@ -332,20 +392,11 @@ void PatternDatabaseFactory::compute_distances(
         }
 
         // regress abstract_state
-        vector<int> applicable_operator_ids;
-        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
-        for (int op_id : applicable_operator_ids) {
-            const AbstractOperator &op = abstract_ops[op_id];
-            int predecessor = state_index + op.get_hash_effect();
-            int alternative_cost = distances[state_index] + op.get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
+        relax_regression_operators(
+            match_tree, state_index, compute_plan,
+            [&](int predecessor, int alternative_cost) {
                 pq.push(alternative_cost, predecessor);
-                if (compute_plan) {
-                    generating_op_ids[predecessor] = op_id;
-                }
-            }
-        }
+            });
     }
 }
 
@@ -378,15 +429,14 @@ void PatternDatabaseFactory::compute_plan(
 
             // Compute equivalent ops
             vector<OperatorID> cheapest_operators;
-            vector<int> applicable_operator_ids;
-            match_tree.get_applicable_operator_ids(successor_state, applicable_operator_ids);
-            for (int applicable_op_id : applicable_operator_ids) {
-                const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
-                int predecessor = successor_state + applicable_op.get_hash_effect();
-                if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
-                    cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
-                }
-            }
+            match_tree.for_each_applicable_operator_id(
+                successor_state, [&](int applicable_op_id) {
+                    const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
+                    int predecessor = successor_state + applicable_op.get_hash_effect();
+                    if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
+                        cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
+                    }
+                });
             if (compute_wildcard_plan) {
                 rng->shuffle(cheapest_operators);
                 wildcard_plan.push_back(move(cheapest_operators));
@@ -435,8 +485,45 @@ shared_ptr<PatternDatabase> compute_pdb(
     const Pattern &pattern,
     const vector<int> &operator_costs,
     const shared_ptr<utils::RandomNumberGenerator> &rng) {
-    PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs, false, rng);
-    return pdb_factory.extract_pdb();
+    auto compute = [&]() {
+            PatternDatabaseFactory pdb_factory(
+                task_proxy, pattern, operator_costs, false, rng);
+            return pdb_factory.extract_pdb();
+        };
+    if (utils::g_cache_directory.empty()) {
+        return compute();
+    }
+    return get_cached_pdb(task_proxy, pattern, operator_costs, compute);
+}
+
+PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads) {
+    int num_patterns = patterns.size();
+    PDBCollection pdbs(num_patterns);
+    num_threads = max(min(utils::get_num_threads(num_threads), num_patterns), 1);
+
+    /*
+      The threads take the patterns in order of decreasing PDB size, so
+      that a large PDB is not left over for the end, when the other threads
+      are already idle.
+    */
+    vector<int> sizes(num_patterns);
+    for (int i = 0; i < num_patterns; ++i) {
+        sizes[i] = compute_pdb_size(task_proxy, patterns[i]);
+    }
+    vector<int> order(num_patterns);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+                    return sizes[lhs] > sizes[rhs];
+                });
+    utils::ThreadPool thread_pool(num_threads);
+    thread_pool.run(num_patterns, [&](int, int task) {
+                        int i = order[task];
+                        pdbs[i] = compute_pdb(task_proxy, patterns[i]);
+                    });
+    return pdbs;
 }
 
 tuple<shared_ptr<PatternDatabase>, vector<vector<OperatorID>>>
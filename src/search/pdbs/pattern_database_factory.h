@@ -29,6 +29,16 @@ extern std::shared_ptr<PatternDatabase> compute_pdb(
     const std::vector<int> &operator_costs = std::vector<int>(),
     const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr);
 
+/*
+  Compute PDBs for all given patterns with the given number of threads
+  (0 = one per hardware thread). The PDBs are independent, so the result is
+  the same as calling compute_pdb() for every pattern in order.
+*/
+extern PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads);
+
 /*
   In addition to computing a PDB for the given task and pattern like
   compute_pdb() above, also compute an abstract plan along.
@@ -8,8 +8,9 @@ using namespace std;
 
 namespace pdbs {
 PatternCollectionGenerator::PatternCollectionGenerator(
-    utils::Verbosity verbosity)
-    : log(utils::get_log_for_verbosity(verbosity)) {
+    int num_threads, utils::Verbosity verbosity)
+    : num_threads(num_threads),
+      log(utils::get_log_for_verbosity(verbosity)) {
 }
 
 PatternCollectionInformation PatternCollectionGenerator::generate(
@@ -19,6 +20,7 @@ PatternCollectionInformation PatternCollectionGenerator::generate(
     }
     utils::Timer timer;
     PatternCollectionInformation pci = compute_patterns(task);
+    pci.set_num_threads(num_threads);
     dump_pattern_collection_generation_statistics(
         name(), timer(), pci, log);
     return pci;
@@ -52,6 +54,29 @@ tuple<utils::Verbosity> get_generator_arguments_from_options(
     return utils::get_log_arguments_from_options(opts);
 }
 
+void add_num_threads_option_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads for computing the PDBs of the pattern collection "
+        "(0 = one per hardware thread). PDBs that the generator computes "
+        "while generating the patterns are only computed in parallel by "
+        "hill climbing.",
+        "1",
+        plugins::Bounds("0", "infinity"));
+}
+
+void add_collection_generator_options_to_feature(plugins::Feature &feature) {
+    add_num_threads_option_to_feature(feature);
+    add_generator_options_to_feature(feature);
+}
+
+tuple<int, utils::Verbosity> get_collection_generator_arguments_from_options(
+    const plugins::Options &opts) {
+    return tuple_cat(
+        make_tuple(opts.get<int>("num_threads")),
+        get_generator_arguments_from_options(opts));
+}
+
 static class PatternCollectionGeneratorCategoryPlugin : public plugins::TypedCategoryPlugin<PatternCollectionGenerator> {
 public:
     PatternCollectionGeneratorCategoryPlugin() : TypedCategoryPlugin("PatternCollectionGenerator") {
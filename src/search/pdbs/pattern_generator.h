@@ -27,9 +27,11 @@ class PatternCollectionGenerator {
     virtual PatternCollectionInformation compute_patterns(
         const std::shared_ptr<AbstractTask> &task) = 0;
 protected:
+    // Number of threads for computing the PDBs of the collection.
+    const int num_threads;
     mutable utils::LogProxy log;
 public:
-    explicit PatternCollectionGenerator(utils::Verbosity verbosity);
+    PatternCollectionGenerator(int num_threads, utils::Verbosity verbosity);
     virtual ~PatternCollectionGenerator() = default;
 
     PatternCollectionInformation generate(
@@ -52,6 +54,12 @@ public:
 extern void add_generator_options_to_feature(plugins::Feature &feature);
 extern std::tuple<utils::Verbosity>
 get_generator_arguments_from_options(const plugins::Options &opts);
+
+extern void add_num_threads_option_to_feature(plugins::Feature &feature);
+extern void add_collection_generator_options_to_feature(
+    plugins::Feature &feature);
+extern std::tuple<int, utils::Verbosity>
+get_collection_generator_arguments_from_options(const plugins::Options &opts);
 }
 
 #endif
@@ -0,0 +1,160 @@
+#include "pdb_cache.h"
+
+#include "pattern_database.h"
+
+#include "../utils/disk_cache.h"
+#include "../utils/hash.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+using namespace std;
+
+namespace pdbs {
+static const char MAGIC[8] = {'F', 'D', 'P', 'D', 'B', '0', '0', '2'};
+/*
+  Written in native byte order. Files written on a machine with a different
+  byte order (and therefore different distances) read a different value.
+*/
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/*
+  File layout: MAGIC, the check hash of the key, BYTE_ORDER_MARK, the number
+  of abstract states, the number of bytes per value and then the distances
+  as returned by PatternDatabase::get_stored_distances(). All numbers are
+  stored in native byte order.
+*/
+struct Header {
+    char magic[8];
+    uint64_t check;
+    uint32_t byte_order;
+    int32_t num_states;
+    int32_t bytes_per_value;
+};
+
+static vector<int> compute_key(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    vector<int> key;
+    auto add_fact = [&key](const FactProxy &fact) {
+            FactPair pair = fact.get_pair();
+            key.push_back(pair.var);
+            key.push_back(pair.value);
+        };
+
+    VariablesProxy variables = task_proxy.get_variables();
+    key.push_back(variables.size());
+    for (VariableProxy var : variables) {
+        key.push_back(var.get_domain_size());
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    key.push_back(operators.size());
+    for (OperatorProxy op : operators) {
+        PreconditionsProxy preconditions = op.get_preconditions();
+        key.push_back(preconditions.size());
+        for (FactProxy pre : preconditions) {
+            add_fact(pre);
+        }
+        EffectsProxy effects = op.get_effects();
+        key.push_back(effects.size());
+        for (EffectProxy effect : effects) {
+            EffectConditionsProxy conditions = effect.get_conditions();
+            key.push_back(conditions.size());
+            for (FactProxy condition : conditions) {
+                add_fact(condition);
+            }
+            add_fact(effect.get_fact());
+        }
+        key.push_back(operator_costs.empty()
+                      ? op.get_cost() : operator_costs[op.get_id()]);
+    }
+
+    GoalsProxy goals = task_proxy.get_goals();
+    key.push_back(goals.size());
+    for (FactProxy goal : goals) {
+        add_fact(goal);
+    }
+
+    key.push_back(pattern.size());
+    key.insert(key.end(), pattern.begin(), pattern.end());
+    return key;
+}
+
+static uint64_t compute_hash(const vector<int> &key, int seed) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, seed);
+    utils::feed(hash_state, key);
+    return hash_state.get_hash64();
+}
+
+static shared_ptr<PatternDatabase> load_pdb(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const string &file_name, uint64_t check) {
+    shared_ptr<const utils::MappedFile> file =
+        utils::open_cache_file(file_name);
+    if (!file || file->get_size() < sizeof(Header)) {
+        return nullptr;
+    }
+    Header header;
+    memcpy(&header, file->get_data(), sizeof(Header));
+    Projection projection(task_proxy, pattern);
+    int bytes_per_value = header.bytes_per_value;
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.byte_order != BYTE_ORDER_MARK ||
+        header.check != check ||
+        header.num_states != projection.get_num_abstract_states() ||
+        (bytes_per_value != 1 && bytes_per_value != 2 &&
+         bytes_per_value != 4) ||
+        file->get_size() != sizeof(Header) +
+        static_cast<size_t>(header.num_states) * bytes_per_value) {
+        return nullptr;
+    }
+    const uint8_t *distances =
+        reinterpret_cast<const uint8_t *>(file->get_data() + sizeof(Header));
+    return make_shared<PatternDatabase>(
+        move(projection), file, distances, bytes_per_value);
+}
+
+static void store_pdb(
+    const PatternDatabase &pdb, const string &file_name, uint64_t check) {
+    utils::write_cache_file(
+        file_name, [&](ostream &stream) {
+            // Value-initialized so that the padding is written as zeros.
+            Header header = {};
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.check = check;
+            header.byte_order = BYTE_ORDER_MARK;
+            header.num_states = pdb.get_size();
+            header.bytes_per_value = pdb.get_bytes_per_value();
+            stream.write(reinterpret_cast<const char *>(&header),
+                         sizeof(Header));
+            stream.write(
+                reinterpret_cast<const char *>(pdb.get_stored_distances()),
+                static_cast<streamsize>(pdb.get_size()) *
+                pdb.get_bytes_per_value());
+        });
+}
+
+shared_ptr<PatternDatabase> get_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs,
+    const function<shared_ptr<PatternDatabase>()> &compute) {
+    vector<int> key = compute_key(task_proxy, pattern, operator_costs);
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "pdb-%016llx.bin",
+             static_cast<unsigned long long>(compute_hash(key, 0)));
+    uint64_t check = compute_hash(key, 1);
+
+    shared_ptr<PatternDatabase> pdb =
+        load_pdb(task_proxy, pattern, file_name, check);
+    if (!pdb) {
+        pdb = compute();
+        store_pdb(*pdb, file_name, check);
+    }
+    return pdb;
+}
+}
@@ -0,0 +1,34 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  Cache of PDBs on disk, which is active if a cache directory is set with
+  --cache-directory (see utils/disk_cache.h).
+
+  A PDB is stored under a hash of everything its distances depend on: the
+  variable domains, the preconditions, effects and costs of the operators
+  and the goals of the task (but not its initial state), the pattern and
+  the operator costs used for the PDB. Structurally identical tasks thus
+  share their PDBs. A second, independent hash is stored in the file and
+  checked on loading. Loaded distances are memory-mapped, not copied.
+
+  get_cached_pdb() returns the PDB from the cache if it is there and
+  otherwise calls compute() and adds the result to the cache.
+*/
+extern std::shared_ptr<PatternDatabase> get_cached_pdb(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const std::vector<int> &operator_costs,
+    const std::function<std::shared_ptr<PatternDatabase>()> &compute);
+}
+
+#endif
@@ -26,6 +26,11 @@ PDBHeuristic::PDBHeuristic(
       pdb(get_pdb_from_generator(task, pattern)) {
 }
 
+shared_ptr<Evaluator> PDBHeuristic::clone_for_worker() const {
+    // The pattern database is shared.
+    return make_shared<PDBHeuristic>(*this);
+}
+
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int h = pdb->get_value(state.get_unpacked_values());
@@ -50,7 +50,7 @@ SearchAlgorithm::SearchAlgorithm(
       log(utils::get_log_for_verbosity(verbosity)),
       state_registry(task_proxy),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, cost_type, log),
       statistics(log),
       bound(bound),
       cost_type(cost_type),
@@ -73,7 +73,7 @@ SearchAlgorithm::SearchAlgorithm(const plugins::Options &opts) // TODO options o
               opts.get<utils::Verbosity>("verbosity"))),
       state_registry(task_proxy),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, opts.get<OperatorCost>("cost_type"), log),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
@@ -1,5 +1,6 @@
 #include "eager_search.h"
 
+#include "../batch_evaluator.h"
 #include "../evaluation_context.h"
 #include "../evaluator.h"
 #include "../open_list_factory.h"
@@ -10,6 +11,7 @@
 #include "../task_utils/successor_generator.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <memory>
@@ -23,10 +25,13 @@ EagerSearch::EagerSearch(
     const shared_ptr<OpenListFactory> &open, bool reopen_closed,
     const shared_ptr<Evaluator> &f_eval,
     const vector<shared_ptr<Evaluator>> &preferred,
+    const vector<vector<shared_ptr<Evaluator>>> &parallel_evals,
     const shared_ptr<PruningMethod> &pruning,
-    const shared_ptr<Evaluator> &lazy_evaluator, OperatorCost cost_type,
-    int bound, double max_time, const string &description,
-    utils::Verbosity verbosity)
+    const shared_ptr<Evaluator> &lazy_evaluator, bool store_parents,
+    bool compress_states, const string &state_directory,
+    int state_ram_budget,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
     : SearchAlgorithm(
           cost_type, bound, max_time, description, verbosity),
       reopen_closed_nodes(reopen_closed),
@@ -39,6 +44,20 @@ EagerSearch::EagerSearch(
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (!parallel_evals.empty()) {
+        batch_evaluator = make_unique<BatchEvaluator>(parallel_evals);
+    }
+    search_space.set_store_parents(store_parents);
+    if (!state_directory.empty()) {
+        state_registry.store_states_on_disk(state_directory, state_ram_budget);
+    }
+    if (compress_states && !state_registry.enable_state_compression()) {
+        log << "States fit into two bins and are stored uncompressed."
+            << endl;
+    }
+}
+
+EagerSearch::~EagerSearch() {
 }
 
 void EagerSearch::initialize() {
@@ -46,6 +65,10 @@ void EagerSearch::initialize() {
         << (reopen_closed_nodes ? " with" : " without")
         << " reopening closed nodes, (real) bound = " << bound
         << endl;
+    if (batch_evaluator) {
+        log << "Evaluating successors with "
+            << batch_evaluator->get_num_threads() << " threads" << endl;
+    }
     assert(open_list);
 
     set<Evaluator *> evals;
@@ -197,12 +220,19 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
+    if (batch_evaluator) {
+        generate_and_evaluate_successors(s, *node, applicable_ops);
+    }
+
+    size_t next_successor = 0;
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node->get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        State succ_state = state_registry.get_successor_state(s, op);
+        State succ_state = batch_evaluator
+            ? move(successor_states[next_successor++])
+            : state_registry.get_successor_state(s, op);
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -284,6 +314,37 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+/*
+  Generate the successors of state in the same order as step() and evaluate
+  the new ones in parallel. step() then processes the successors as usual,
+  but the evaluator values of the new successors are cached already.
+*/
+void EagerSearch::generate_and_evaluate_successors(
+    const State &state, const SearchNode &node,
+    const vector<OperatorID> &applicable_ops) {
+    successor_states.clear();
+    new_successor_states.clear();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node.get_real_g() + op.get_cost()) >= bound)
+            continue;
+
+        State succ_state = state_registry.get_successor_state(state, op);
+        /*
+          A state reached by several operators must be evaluated only once.
+          The number of new successors is usually small, so we search them
+          linearly.
+        */
+        if (search_space.get_node(succ_state).is_new() &&
+            find(new_successor_states.begin(), new_successor_states.end(),
+                 succ_state) == new_successor_states.end()) {
+            new_successor_states.push_back(succ_state);
+        }
+        successor_states.push_back(move(succ_state));
+    }
+    batch_evaluator->evaluate(new_successor_states, statistics);
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -315,16 +376,48 @@ void add_eager_search_options_to_feature(
     add_search_pruning_options_to_feature(feature);
     // We do not add a lazy_evaluator options here
     // because it is only used for astar but not the other plugins.
+    feature.add_option<bool>(
+        "store_parents",
+        "store the parent state and creating operator of every state. "
+        "Without them, the plan is recovered by regression from the goal "
+        "state over the reached states, which is only supported for tasks "
+        "without axioms and conditional effects",
+        "true");
+    feature.add_option<bool>(
+        "compress_states",
+        "store the registered states with tree compression. This saves "
+        "memory if states consist of many bins that are shared with other "
+        "states, at the cost of compressing every generated state and "
+        "decompressing states that are looked up",
+        "false");
+    feature.add_option<string>(
+        "state_directory",
+        "if not empty, store the data of the registered states in "
+        "memory-mapped temporary files in this directory instead of RAM. "
+        "Search node information and the hash set for duplicate detection "
+        "are still kept in RAM. Cannot be combined with compress_states",
+        "\"\"");
+    feature.add_option<int>(
+        "state_ram_budget",
+        "maximum amount of memory-mapped state data in MB that is kept in "
+        "RAM if state_directory is set. Older state data is paged in from "
+        "disk when it is accessed",
+        "1024",
+        plugins::Bounds("0", "infinity"));
     add_search_algorithm_options_to_feature(feature, description);
 }
 
-tuple<shared_ptr<PruningMethod>, shared_ptr<Evaluator>, OperatorCost,
-      int, double, string, utils::Verbosity>
+tuple<shared_ptr<PruningMethod>, shared_ptr<Evaluator>, bool, bool, string,
+      int, OperatorCost, int, double, string, utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts) {
     return tuple_cat(
         get_search_pruning_arguments_from_options(opts),
         make_tuple(opts.get<shared_ptr<Evaluator>>(
-                       "lazy_evaluator", nullptr)),
+                       "lazy_evaluator", nullptr),
+                   opts.get<bool>("store_parents"),
+                   opts.get<bool>("compress_states"),
+                   opts.get<string>("state_directory"),
+                   opts.get<int>("state_ram_budget")),
         get_search_algorithm_arguments_from_options(opts)
         );
 }
@@ -7,6 +7,7 @@
 #include <memory>
 #include <vector>
 
+class BatchEvaluator;
 class Evaluator;
 class PruningMethod;
 class OpenListFactory;
@@ -28,6 +29,14 @@ class EagerSearch : public SearchAlgorithm {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    // Only used with parallel evaluation.
+    std::unique_ptr<BatchEvaluator> batch_evaluator;
+    std::vector<State> successor_states;
+    std::vector<State> new_successor_states;
+
+    void generate_and_evaluate_successors(
+        const State &state, const SearchNode &node,
+        const std::vector<OperatorID> &applicable_ops);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -41,10 +50,14 @@ public:
         const std::shared_ptr<OpenListFactory> &open,
         bool reopen_closed, const std::shared_ptr<Evaluator> &f_eval,
         const std::vector<std::shared_ptr<Evaluator>> &preferred,
+        const std::vector<std::vector<std::shared_ptr<Evaluator>>> &parallel_evals,
         const std::shared_ptr<PruningMethod> &pruning,
-        const std::shared_ptr<Evaluator> &lazy_evaluator,
+        const std::shared_ptr<Evaluator> &lazy_evaluator, bool store_parents,
+        bool compress_states, const std::string &state_directory,
+        int state_ram_budget,
         OperatorCost cost_type, int bound, double max_time,
         const std::string &description, utils::Verbosity verbosity);
+    virtual ~EagerSearch() override;
 
     virtual void print_statistics() const override;
 
@@ -54,8 +67,9 @@ public:
 extern void add_eager_search_options_to_feature(
     plugins::Feature &feature, const std::string &description);
 extern std::tuple<std::shared_ptr<PruningMethod>,
-                  std::shared_ptr<Evaluator>, OperatorCost, int, double,
-                  std::string, utils::Verbosity>
+                  std::shared_ptr<Evaluator>, bool, bool, std::string, int,
+                  OperatorCost, int, double, std::string,
+                  utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts);
 }
 
@@ -0,0 +1,484 @@
+#include "external_bfs_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <set>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace external_bfs_search {
+// Maximum number of runs that are merged at once.
+static const int MAX_MERGE_FAN_IN = 256;
+
+class StateFileWriter {
+    filesystem::path path;
+    ofstream stream;
+    const int num_bins;
+    size_t num_states;
+public:
+    StateFileWriter(const filesystem::path &path, int num_bins)
+        : path(path),
+          stream(path, ios::binary | ios::trunc),
+          num_bins(num_bins),
+          num_states(0) {
+        if (!stream) {
+            cerr << "Could not create " << path << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+
+    void write(const PackedStateBin *state) {
+        stream.write(reinterpret_cast<const char *>(state),
+                     num_bins * sizeof(PackedStateBin));
+        ++num_states;
+    }
+
+    // Returns the number of written states.
+    size_t close() {
+        stream.close();
+        if (stream.fail()) {
+            cerr << "Could not write " << path << " (disk full?)" << endl;
+            utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+        }
+        return num_states;
+    }
+};
+
+class StateFileReader {
+    ifstream stream;
+    const int num_bins;
+    vector<PackedStateBin> current;
+    bool valid;
+public:
+    StateFileReader(const filesystem::path &path, int num_bins)
+        : stream(path, ios::binary),
+          num_bins(num_bins),
+          current(num_bins),
+          valid(false) {
+        if (!stream) {
+            cerr << "Could not open " << path << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        advance();
+    }
+
+    bool at_end() const {
+        return !valid;
+    }
+
+    const PackedStateBin *get() const {
+        assert(valid);
+        return current.data();
+    }
+
+    void advance() {
+        valid = static_cast<bool>(
+            stream.read(reinterpret_cast<char *>(current.data()),
+                        num_bins * sizeof(PackedStateBin)));
+        if (stream.bad()) {
+            cerr << "Could not read a state file." << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+};
+
+static void remove_file(const filesystem::path &path) {
+    error_code error;
+    filesystem::remove(path, error);
+    if (error) {
+        cerr << "Could not remove " << path << ": " << error.message() << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+/*
+  Merges sorted files of distinct states. Calls handle(state, sources) for
+  every state that occurs in any of the files, in sorted order. Bit i of
+  sources is set if the state occurs in a file whose group is i.
+*/
+static void merge_state_files(
+    const vector<filesystem::path> &paths, const vector<int> &groups,
+    int num_bins,
+    const function<void(const PackedStateBin *, unsigned int)> &handle) {
+    assert(paths.size() == groups.size());
+    vector<unique_ptr<StateFileReader>> readers;
+    readers.reserve(paths.size());
+    for (const filesystem::path &path : paths) {
+        readers.push_back(make_unique<StateFileReader>(path, num_bins));
+    }
+    auto is_greater = [&](int lhs, int rhs) {
+            const PackedStateBin *lhs_state = readers[lhs]->get();
+            const PackedStateBin *rhs_state = readers[rhs]->get();
+            return lexicographical_compare(
+                rhs_state, rhs_state + num_bins, lhs_state, lhs_state + num_bins);
+        };
+    priority_queue<int, vector<int>, decltype(is_greater)> heap(is_greater);
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (!readers[i]->at_end()) {
+            heap.push(i);
+        }
+    }
+    vector<PackedStateBin> state(num_bins);
+    while (!heap.empty()) {
+        int reader = heap.top();
+        heap.pop();
+        const PackedStateBin *min_state = readers[reader]->get();
+        copy(min_state, min_state + num_bins, state.begin());
+        unsigned int sources = 0;
+        while (true) {
+            sources |= 1U << groups[reader];
+            readers[reader]->advance();
+            if (!readers[reader]->at_end()) {
+                heap.push(reader);
+            }
+            if (heap.empty() ||
+                !equal(state.begin(), state.end(), readers[heap.top()]->get())) {
+                break;
+            }
+            reader = heap.top();
+            heap.pop();
+        }
+        handle(state.data(), sources);
+    }
+}
+
+ExternalBFSSearch::ExternalBFSSearch(
+    const shared_ptr<Evaluator> &eval, const string &directory,
+    int buffer_size, OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      evaluator(eval),
+      directory(filesystem::path(directory) /
+                ("downward-external-bfs-" + to_string(utils::get_process_id()))),
+      max_buffered_states(
+          max<size_t>(
+              static_cast<size_t>(buffer_size) * 1024 * 1024 /
+              (state_registry.get_state_size_in_bytes() + sizeof(size_t)),
+              1)),
+      num_bins(state_registry.get_state_packer().get_num_bins()),
+      depth(0),
+      num_states_in_layer(0),
+      num_states_in_earlier_layers(0),
+      next_run(0) {
+    if (evaluator) {
+        set<Evaluator *> path_dependent_evaluators;
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "External breadth-first search does not support "
+                 << "path-dependent evaluators." << endl;
+            utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+    if (bound != numeric_limits<int>::max() && !is_unit_cost) {
+        cerr << "External breadth-first search only supports bounds for "
+             << "unit-cost tasks." << endl;
+        utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+    }
+    // Fail before any search work is done if the directory is unusable.
+    error_code error;
+    filesystem::create_directories(this->directory, error);
+    if (error) {
+        cerr << "Could not create directory " << this->directory << ": "
+             << error.message() << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+ExternalBFSSearch::~ExternalBFSSearch() {
+    error_code error;
+    filesystem::remove_all(directory, error);
+}
+
+filesystem::path ExternalBFSSearch::get_layer_path(int layer) const {
+    return directory / ("layer-" + to_string(layer));
+}
+
+filesystem::path ExternalBFSSearch::get_run_path(int run) const {
+    return directory / ("run-" + to_string(run));
+}
+
+filesystem::path ExternalBFSSearch::get_visited_path(int layer) const {
+    return directory / ("visited-" + to_string(layer));
+}
+
+void ExternalBFSSearch::pack(const State &state, PackedStateBin *buffer) const {
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    state_packer.pack_all(state.get_unpacked_values().data(), buffer);
+}
+
+State ExternalBFSSearch::unpack(const PackedStateBin *buffer) const {
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    vector<int> values(task_proxy.get_variables().size());
+    state_packer.unpack_all(buffer, values.data());
+    return task_proxy.create_state(move(values));
+}
+
+bool ExternalBFSSearch::is_pruned(const State &state, int g) {
+    if (!evaluator) {
+        return false;
+    }
+    EvaluationContext eval_context(state, g, false, &statistics);
+    statistics.inc_evaluated_states();
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        statistics.inc_dead_ends();
+        return true;
+    }
+    int h = eval_context.get_evaluator_value(evaluator.get());
+    return is_unit_cost && g + h >= bound;
+}
+
+void ExternalBFSSearch::write_run(vector<PackedStateBin> &buffer, int run) const {
+    size_t num_states = buffer.size() / num_bins;
+    vector<size_t> order(num_states);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+             const PackedStateBin *lhs_state = &buffer[lhs * num_bins];
+             const PackedStateBin *rhs_state = &buffer[rhs * num_bins];
+             return lexicographical_compare(
+                 lhs_state, lhs_state + num_bins, rhs_state, rhs_state + num_bins);
+         });
+    StateFileWriter writer(get_run_path(run), num_bins);
+    const PackedStateBin *last_state = nullptr;
+    for (size_t index : order) {
+        const PackedStateBin *state = &buffer[index * num_bins];
+        if (!last_state || !equal(state, state + num_bins, last_state)) {
+            writer.write(state);
+        }
+        last_state = state;
+    }
+    writer.close();
+    buffer.clear();
+}
+
+vector<filesystem::path> ExternalBFSSearch::merge_runs(
+    const vector<filesystem::path> &runs) {
+    vector<filesystem::path> merged_runs = runs;
+    while (merged_runs.size() > MAX_MERGE_FAN_IN) {
+        vector<filesystem::path> next_runs;
+        for (size_t begin = 0; begin < merged_runs.size();
+             begin += MAX_MERGE_FAN_IN) {
+            size_t end = min(begin + MAX_MERGE_FAN_IN, merged_runs.size());
+            vector<filesystem::path> paths(
+                merged_runs.begin() + begin, merged_runs.begin() + end);
+            next_runs.push_back(get_run_path(next_run++));
+            StateFileWriter writer(next_runs.back(), num_bins);
+            merge_state_files(
+                paths, vector<int>(paths.size(), 0), num_bins,
+                [&](const PackedStateBin *state, unsigned int) {
+                    writer.write(state);
+                });
+            writer.close();
+            for (const filesystem::path &path : paths) {
+                remove_file(path);
+            }
+        }
+        merged_runs.swap(next_runs);
+    }
+    return merged_runs;
+}
+
+void ExternalBFSSearch::extract_plan(const vector<PackedStateBin> &goal_state) {
+    Plan plan;
+    vector<PackedStateBin> target = goal_state;
+    vector<PackedStateBin> successor(num_bins);
+    vector<OperatorID> applicable_ops;
+    for (int layer = depth - 1; layer >= 0; --layer) {
+        bool found = false;
+        for (StateFileReader reader(get_layer_path(layer), num_bins);
+             !found && !reader.at_end(); reader.advance()) {
+            State state = unpack(reader.get());
+            applicable_ops.clear();
+            successor_generator.generate_applicable_ops(state, applicable_ops);
+            for (OperatorID op_id : applicable_ops) {
+                OperatorProxy op = task_proxy.get_operators()[op_id];
+                pack(state.get_unregistered_successor(op), successor.data());
+                if (successor == target) {
+                    plan.push_back(op_id);
+                    target.assign(reader.get(), reader.get() + num_bins);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) {
+            cerr << "No predecessor found in layer " << layer << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void ExternalBFSSearch::initialize() {
+    log << "Conducting external breadth-first search in " << directory
+        << ", (real) bound = " << bound << endl;
+    log << "Buffering up to " << max_buffered_states
+        << " states per sorted run" << endl;
+
+    vector<PackedStateBin> buffer(num_bins);
+    State initial_state = task_proxy.get_initial_state();
+    pack(initial_state, buffer.data());
+    StateFileWriter writer(get_layer_path(0), num_bins);
+    writer.write(buffer.data());
+    num_states_in_layer = writer.close();
+    // The file of states in earlier layers starts out empty.
+    StateFileWriter(get_visited_path(0), num_bins).close();
+}
+
+SearchStatus ExternalBFSSearch::step() {
+    if (num_states_in_layer == 0) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    if (is_unit_cost && depth >= bound) {
+        log << "All states below the bound explored -- no solution!" << endl;
+        return FAILED;
+    }
+    log << "Layer " << depth << ": " << num_states_in_layer << " states"
+        << endl;
+
+    vector<PackedStateBin> buffer;
+    vector<filesystem::path> runs;
+    vector<OperatorID> applicable_ops;
+    for (StateFileReader reader(get_layer_path(depth), num_bins);
+         !reader.at_end(); reader.advance()) {
+        State state = unpack(reader.get());
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            log << "Solution found!" << endl;
+            extract_plan(vector<PackedStateBin>(
+                             reader.get(), reader.get() + num_bins));
+            return SOLVED;
+        }
+        if (is_pruned(state, depth)) {
+            continue;
+        }
+        statistics.inc_expanded();
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        statistics.inc_generated_ops(applicable_ops.size());
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            State succ_state = state.get_unregistered_successor(op);
+            statistics.inc_generated();
+            size_t pos = buffer.size();
+            buffer.resize(pos + num_bins);
+            pack(succ_state, &buffer[pos]);
+            if (buffer.size() == max_buffered_states * num_bins) {
+                runs.push_back(get_run_path(next_run));
+                write_run(buffer, next_run++);
+            }
+        }
+    }
+    if (!buffer.empty()) {
+        runs.push_back(get_run_path(next_run));
+        write_run(buffer, next_run++);
+    }
+    runs = merge_runs(runs);
+
+    /*
+      Successors (group 0) that are neither in an earlier layer nor in the
+      current layer (group 1) form the next layer.
+    */
+    vector<filesystem::path> paths = runs;
+    vector<int> groups(runs.size(), 0);
+    paths.push_back(get_visited_path(depth));
+    paths.push_back(get_layer_path(depth));
+    groups.insert(groups.end(), 2, 1);
+    StateFileWriter next_layer(get_layer_path(depth + 1), num_bins);
+    StateFileWriter visited(get_visited_path(depth + 1), num_bins);
+    merge_state_files(
+        paths, groups, num_bins,
+        [&](const PackedStateBin *state, unsigned int sources) {
+            if (sources & 2) {
+                visited.write(state);
+            } else {
+                next_layer.write(state);
+            }
+        });
+    visited.close();
+    for (const filesystem::path &run : runs) {
+        remove_file(run);
+    }
+    remove_file(get_visited_path(depth));
+
+    num_states_in_earlier_layers += num_states_in_layer;
+    num_states_in_layer = next_layer.close();
+    ++depth;
+    return IN_PROGRESS;
+}
+
+void ExternalBFSSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Number of layers: " << depth + 1 << endl;
+    log << "Number of distinct states: "
+        << num_states_in_earlier_layers + num_states_in_layer << endl;
+}
+
+class ExternalBFSSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, ExternalBFSSearch> {
+public:
+    ExternalBFSSearchFeature() : TypedFeature("external_bfs") {
+        document_title("External breadth-first search");
+        document_synopsis(
+            "Breadth-first search with delayed duplicate detection that "
+            "stores the search layers as sorted files of packed states on "
+            "disk. Finds plans with the minimal number of operators.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for pruning dead ends and, for unit-cost tasks, "
+            "states whose g+h value reaches the bound. "
+            "(Optional; without an evaluator, only the bound prunes states.)",
+            plugins::ArgumentInfo::NO_DEFAULT);
+        add_option<string>(
+            "directory",
+            "directory for the temporary files of the search",
+            "\".\"");
+        add_option<int>(
+            "buffer_size",
+            "memory in MB for buffering successor states before they are "
+            "sorted and written to disk",
+            "256",
+            plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "external_bfs");
+
+        document_note(
+            "Memory usage",
+            "The memory usage does not grow with the number of states, but "
+            "each layer is read once for expanding it and once for every "
+            "later layer for duplicate detection. The files are removed "
+            "when the search ends.");
+        document_note(
+            "Bound",
+            "The bound is only supported for unit-cost tasks.");
+    }
+
+    virtual shared_ptr<ExternalBFSSearch> create_component(
+        const plugins::Options &opts,
+        const utils::Context &) const override {
+        return plugins::make_shared_from_arg_tuples<ExternalBFSSearch>(
+            opts.get<shared_ptr<Evaluator>>("eval", nullptr),
+            opts.get<string>("directory"),
+            opts.get<int>("buffer_size"),
+            get_search_algorithm_arguments_from_options(opts)
+            );
+    }
+};
+
+static plugins::FeaturePlugin<ExternalBFSSearchFeature> _plugin;
+}
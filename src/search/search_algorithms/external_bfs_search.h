@@ -0,0 +1,69 @@
+#ifndef SEARCH_ALGORITHMS_EXTERNAL_BFS_SEARCH_H
+#define SEARCH_ALGORITHMS_EXTERNAL_BFS_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Evaluator;
+
+namespace external_bfs_search {
+/*
+  Breadth-first search with delayed duplicate detection that keeps the
+  search space on disk.
+
+  Every layer of the search is a file of sorted, distinct packed states.
+  Expanding a layer collects the successors in a buffer of bounded size,
+  which is sorted and written to a run file whenever it is full. Merging
+  the runs with the file of all states in earlier layers yields the next
+  layer (all successors that were not reached before) and the updated file
+  of earlier states in one pass. RAM usage is thus bounded by the buffer
+  and does not grow with the number of states.
+
+  A plan is reconstructed backwards from the goal state by scanning the
+  layers for a predecessor of the current state.
+*/
+class ExternalBFSSearch : public SearchAlgorithm {
+    std::shared_ptr<Evaluator> evaluator;
+    const std::filesystem::path directory;
+    const size_t max_buffered_states;
+    const int num_bins;
+
+    // Number of the layer that is expanded in the next step.
+    int depth;
+    size_t num_states_in_layer;
+    size_t num_states_in_earlier_layers;
+    // Number of the next run file.
+    int next_run;
+
+    std::filesystem::path get_layer_path(int layer) const;
+    std::filesystem::path get_run_path(int run) const;
+    std::filesystem::path get_visited_path(int layer) const;
+
+    void pack(const State &state, PackedStateBin *buffer) const;
+    State unpack(const PackedStateBin *buffer) const;
+    bool is_pruned(const State &state, int g);
+    void write_run(std::vector<PackedStateBin> &buffer, int run) const;
+    std::vector<std::filesystem::path> merge_runs(
+        const std::vector<std::filesystem::path> &runs);
+    void extract_plan(const std::vector<PackedStateBin> &goal_state);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    ExternalBFSSearch(
+        const std::shared_ptr<Evaluator> &eval, const std::string &directory,
+        int buffer_size, OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~ExternalBFSSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
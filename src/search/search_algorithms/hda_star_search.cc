@@ -0,0 +1,484 @@
+#include "hda_star_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../per_state_information.h"
+
+#include "../algorithms/message_queue.h"
+#include "../parser/decorated_abstract_syntax_tree.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/parallel.h"
+
+#include <cassert>
+#include <climits>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_star_search {
+// Number of expansions between two checks of the time limit.
+static const int TIMER_CHECK_INTERVAL = 1000;
+
+/*
+  A state sent to its owner, together with the path by which it was
+  reached. The parent is identified by its worker and its ID in the state
+  registry of that worker.
+*/
+struct Message {
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_id;
+    OperatorID creating_operator_id;
+};
+
+// Messages for one receiver. The packed state data of all messages is stored consecutively in buffers.
+struct MessageBatch {
+    vector<PackedStateBin> buffers;
+    vector<Message> messages;
+
+    bool empty() const {
+        return messages.empty();
+    }
+};
+
+struct NodeInfo {
+    enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
+
+    NodeStatus status = NEW;
+    int g = -1;
+    int real_g = -1;
+    int parent_worker = -1;
+    StateID parent_id = StateID::no_state;
+    OperatorID creating_operator_id = OperatorID::no_operator;
+};
+
+class HDAStarSearch::Worker {
+    HDAStarSearch &search;
+    const int id;
+    const int num_bins;
+
+    shared_ptr<Evaluator> eval;
+    shared_ptr<Evaluator> f_evaluator;
+    unique_ptr<StateOpenList> open_list;
+
+    vector<MessageBatch> outgoing_batches;
+    vector<MessageBatch> received_batches;
+    vector<PackedStateBin> successor_buffer;
+    vector<OperatorID> applicable_ops;
+
+    void send(int receiver, const Message &message);
+    void flush_outgoing_batches();
+    void receive_state(const PackedStateBin *buffer, const Message &message);
+public:
+    StateRegistry state_registry;
+    PerStateInformation<NodeInfo> nodes;
+    SearchStatistics statistics;
+    message_queue::MessageQueue<MessageBatch> inbox;
+
+    Worker(HDAStarSearch &search, int id, int num_workers,
+           const shared_ptr<Evaluator> &eval);
+
+    /*
+      Workers never evaluate states in the same evaluation context, so their
+      evaluators can store results in the same cache slots.
+    */
+    void share_cache_slots(const Worker &other);
+    void insert_initial_state(const PackedStateBin *buffer);
+    /*
+      Insert all received states into the open list. Returns the number of
+      received batches.
+    */
+    int receive_messages();
+    /*
+      Expand the next state with f < incumbent. Returns false if there is no
+      such state.
+    */
+    bool expand_next_state();
+};
+
+HDAStarSearch::Worker::Worker(
+    HDAStarSearch &search, int id, int num_workers,
+    const shared_ptr<Evaluator> &eval)
+    : search(search),
+      id(id),
+      num_bins(search.state_registry.get_state_packer().get_num_bins()),
+      eval(eval),
+      outgoing_batches(num_workers),
+      successor_buffer(num_bins),
+      state_registry(search.task_proxy),
+      statistics(search.log) {
+    auto open_list_factory_and_f_eval =
+        search_common::create_astar_open_list_factory_and_f_eval(
+            eval, utils::Verbosity::SILENT);
+    open_list = open_list_factory_and_f_eval.first->create_state_open_list();
+    f_evaluator = open_list_factory_and_f_eval.second;
+}
+
+void HDAStarSearch::Worker::share_cache_slots(const Worker &other) {
+    f_evaluator->share_cache_slots(*other.f_evaluator);
+}
+
+void HDAStarSearch::Worker::insert_initial_state(const PackedStateBin *buffer) {
+    State initial_state = state_registry.register_state(buffer);
+    EvaluationContext eval_context(initial_state, 0, true, nullptr);
+    if (open_list->is_dead_end(eval_context)) {
+        search.log << "Initial state is a dead end." << endl;
+    }
+    print_initial_evaluator_values(eval_context);
+    Message message {0, 0, -1, StateID::no_state, OperatorID::no_operator};
+    receive_state(buffer, message);
+}
+
+void HDAStarSearch::Worker::send(int receiver, const Message &message) {
+    MessageBatch &batch = outgoing_batches[receiver];
+    batch.buffers.insert(
+        batch.buffers.end(), successor_buffer.begin(), successor_buffer.end());
+    batch.messages.push_back(message);
+}
+
+void HDAStarSearch::Worker::flush_outgoing_batches() {
+    for (size_t receiver = 0; receiver < outgoing_batches.size(); ++receiver) {
+        MessageBatch &batch = outgoing_batches[receiver];
+        if (!batch.empty()) {
+            // The batch counts as work until the receiver has processed it.
+            ++search.work_count;
+            search.workers[receiver]->inbox.push(move(batch));
+            batch = MessageBatch();
+        }
+    }
+}
+
+void HDAStarSearch::Worker::receive_state(
+    const PackedStateBin *buffer, const Message &message) {
+    State state = state_registry.register_state(buffer);
+    NodeInfo &node = nodes[state];
+    if (node.status == NodeInfo::DEAD_END ||
+        (node.status != NodeInfo::NEW && node.g <= message.g)) {
+        return;
+    }
+    EvaluationContext eval_context(state, message.g, false, &statistics);
+    if (node.status == NodeInfo::NEW) {
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(eval_context)) {
+            node.status = NodeInfo::DEAD_END;
+            statistics.inc_dead_ends();
+            return;
+        }
+    } else if (node.status == NodeInfo::CLOSED) {
+        statistics.inc_reopened();
+    }
+    node.status = NodeInfo::OPEN;
+    node.g = message.g;
+    node.real_g = message.real_g;
+    node.parent_worker = message.parent_worker;
+    node.parent_id = message.parent_id;
+    node.creating_operator_id = message.creating_operator_id;
+    open_list->insert(eval_context, state.get_id());
+}
+
+int HDAStarSearch::Worker::receive_messages() {
+    received_batches.clear();
+    inbox.pop_all(received_batches);
+    for (const MessageBatch &batch : received_batches) {
+        for (size_t i = 0; i < batch.messages.size(); ++i) {
+            receive_state(&batch.buffers[i * num_bins], batch.messages[i]);
+        }
+    }
+    return received_batches.size();
+}
+
+bool HDAStarSearch::Worker::expand_next_state() {
+    while (!open_list->empty()) {
+        StateID state_id = open_list->remove_min();
+        State state = state_registry.lookup_state(state_id);
+        NodeInfo &node = nodes[state];
+        // Skip outdated open list entries.
+        if (node.status != NodeInfo::OPEN)
+            continue;
+
+        EvaluationContext eval_context(state, node.g, false, &statistics);
+        int f = eval_context.get_evaluator_value_or_infinity(f_evaluator.get());
+        /*
+          The state cannot lead to a cheaper plan than the incumbent. If it is
+          reached with a lower g value later, it is inserted again.
+        */
+        if (f >= search.incumbent_cost)
+            continue;
+
+        node.status = NodeInfo::CLOSED;
+        statistics.inc_expanded();
+        if (task_properties::is_goal_state(search.task_proxy, state)) {
+            search.report_goal(node.g, id, state_id);
+            return true;
+        }
+
+        applicable_ops.clear();
+        search.successor_generator.generate_applicable_ops(state, applicable_ops);
+        statistics.inc_generated_ops(applicable_ops.size());
+        const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = search.task_proxy.get_operators()[op_id];
+            if ((node.real_g + op.get_cost()) >= search.bound)
+                continue;
+            int succ_g = node.g + search.get_adjusted_cost(op);
+            if (succ_g >= search.incumbent_cost)
+                continue;
+
+            copy(state.get_buffer(), state.get_buffer() + num_bins,
+                 successor_buffer.begin());
+            for (EffectProxy effect : op.get_effects()) {
+                if (does_fire(effect, state)) {
+                    FactPair effect_pair = effect.get_fact().get_pair();
+                    state_packer.set(successor_buffer.data(), effect_pair.var, effect_pair.value);
+                }
+            }
+            statistics.inc_generated();
+
+            Message message {succ_g, node.real_g + op.get_cost(), id, state_id, op_id};
+            int owner = search.get_owner(successor_buffer.data());
+            if (owner == id) {
+                /*
+                  Registering the successor may add states to the registry,
+                  but does not invalidate node (see PerStateInformation).
+                */
+                receive_state(successor_buffer.data(), message);
+            } else {
+                send(owner, message);
+            }
+        }
+        flush_outgoing_batches();
+        return true;
+    }
+    return false;
+}
+
+
+HDAStarSearch::HDAStarSearch(
+    const vector<shared_ptr<Evaluator>> &evals,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      incumbent_cost(INT_MAX),
+      goal_worker(-1),
+      goal_state_id(StateID::no_state),
+      work_count(0),
+      timed_out(false) {
+    if (task_properties::has_axioms(task_proxy)) {
+        cerr << "HDA* does not support axioms." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    set<Evaluator *> path_dependent_evaluators;
+    for (const shared_ptr<Evaluator> &eval : evals) {
+        eval->get_path_dependent_evaluators(path_dependent_evaluators);
+    }
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "HDA* does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    workers.reserve(evals.size());
+    for (size_t i = 0; i < evals.size(); ++i) {
+        workers.push_back(utils::make_unique_ptr<Worker>(*this, i, evals.size(), evals[i]));
+        if (i > 0) {
+            workers[i]->share_cache_slots(*workers[0]);
+        }
+    }
+}
+
+HDAStarSearch::~HDAStarSearch() {
+}
+
+/*
+  The state registries of the workers use the low bits of the same hash for
+  their hash sets, so we distribute states by the high bits.
+*/
+int HDAStarSearch::get_owner(const PackedStateBin *buffer) const {
+    uint64_t hash = StateRegistry::get_packed_state_hash(
+        buffer, state_registry.get_state_packer().get_num_bins());
+    return static_cast<int>((hash * workers.size()) >> 32);
+}
+
+void HDAStarSearch::report_goal(int g, int worker, StateID state_id) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost) {
+        incumbent_cost = g;
+        goal_worker = worker;
+        goal_state_id = state_id;
+    }
+}
+
+void HDAStarSearch::initialize() {
+    log << "Conducting HDA* search with " << workers.size() << " threads"
+        << ", (real) bound = " << bound << endl;
+
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    vector<PackedStateBin> buffer(state_packer.get_num_bins());
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    state_packer.pack_all(
+        initial_state.get_unpacked_values().data(), buffer.data());
+    workers[get_owner(buffer.data())]->insert_initial_state(buffer.data());
+}
+
+void HDAStarSearch::run_worker(Worker &worker, const utils::CountdownTimer &timer) {
+    bool busy = true;
+    int num_expansions = 0;
+    while (!timed_out) {
+        if (!worker.inbox.empty()) {
+            if (!busy) {
+                busy = true;
+                ++work_count;
+            }
+            work_count -= worker.receive_messages();
+        }
+        if (busy) {
+            if (!worker.expand_next_state()) {
+                busy = false;
+                --work_count;
+            } else if (++num_expansions % TIMER_CHECK_INTERVAL == 0 && timer.is_expired()) {
+                timed_out = true;
+            }
+        } else if (work_count == 0) {
+            // All workers are idle and no messages are in transit.
+            break;
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+SearchStatus HDAStarSearch::step() {
+    utils::CountdownTimer timer(max_time);
+    // All workers start busy.
+    work_count = workers.size();
+    vector<thread> threads;
+    for (size_t i = 1; i < workers.size(); ++i) {
+        threads.emplace_back(
+            &HDAStarSearch::run_worker, this, ref(*workers[i]), cref(timer));
+    }
+    run_worker(*workers[0], timer);
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (timed_out) {
+        log << "Time limit reached. Abort search." << endl;
+        return TIMEOUT;
+    }
+    if (goal_worker == -1) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    log << "Solution found!" << endl;
+    set_plan(trace_path());
+    return SOLVED;
+}
+
+Plan HDAStarSearch::trace_path() const {
+    Plan path;
+    int worker_id = goal_worker;
+    StateID state_id = goal_state_id;
+    while (true) {
+        const Worker &worker = *workers[worker_id];
+        const NodeInfo &node =
+            worker.nodes[worker.state_registry.lookup_state(state_id)];
+        if (node.creating_operator_id == OperatorID::no_operator) {
+            assert(node.parent_worker == -1);
+            break;
+        }
+        path.push_back(node.creating_operator_id);
+        worker_id = node.parent_worker;
+        state_id = node.parent_id;
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    size_t num_registered_states = 0;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        const Worker &worker = *workers[i];
+        num_registered_states += worker.state_registry.size();
+        log << "Worker " << i << ": " << worker.statistics.get_expanded()
+            << " expanded, " << worker.state_registry.size()
+            << " registered states" << endl;
+    }
+    log << "Number of registered states: " << num_registered_states << endl;
+}
+
+class HDAStarSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, HDAStarSearch> {
+public:
+    HDAStarSearchFeature() : TypedFeature("hdastar") {
+        document_title("Hash distributed A* (HDA*)");
+        document_synopsis(
+            "Parallel A* search. The state space is partitioned among the "
+            "worker threads by a hash of the states. Every worker expands "
+            "its own states and sends generated states to their owners "
+            "through lock-free message queues.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value. Every worker uses its own instance.",
+            "",
+            plugins::Bounds::unlimited(),
+            true);
+        add_option<int>(
+            "num_threads",
+            "number of worker threads (0 = one per hardware thread)",
+            "0",
+            plugins::Bounds("0", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "hdastar");
+
+        document_note(
+            "Evaluators",
+            "Every worker uses its own instance of the evaluator. If the "
+            "evaluator supports cloning, the instances share the data "
+            "computed in the preprocessing, which is then only done once. "
+            "Otherwise, the evaluator is constructed once per worker and "
+            "must not be predefined with let().");
+        document_note(
+            "Supported tasks",
+            "HDA* supports neither axioms nor path-dependent evaluators.");
+        document_note(
+            "Optimality",
+            "The search is optimal for admissible heuristics. The number of "
+            "expanded states and the plan found can differ between runs.");
+    }
+
+    virtual shared_ptr<HDAStarSearch> create_component(
+        const plugins::Options &opts,
+        const utils::Context &context) const override {
+        int num_threads = utils::get_num_threads(opts.get<int>("num_threads"));
+        vector<shared_ptr<Evaluator>> evals =
+            search_common::create_worker_evaluators(
+                opts.get<parser::LazyValue>("eval"), num_threads, context);
+        return make_shared<HDAStarSearch>(
+            evals, opts.get<OperatorCost>("cost_type"), opts.get<int>("bound"),
+            opts.get<double>("max_time"), opts.get<string>("description"),
+            opts.get<utils::Verbosity>("verbosity"));
+    }
+};
+
+static plugins::FeaturePlugin<HDAStarSearchFeature> _plugin;
+}
@@ -0,0 +1,69 @@
+#ifndef SEARCH_ALGORITHMS_HDA_STAR_SEARCH_H
+#define SEARCH_ALGORITHMS_HDA_STAR_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace hda_star_search {
+/*
+  Hash distributed A* (HDA*) with one thread per worker.
+
+  Every state has an owner worker, determined by the hash of its packed
+  data. Each worker owns the state registry, search nodes, open list and
+  evaluators for its part of the state space. When a worker expands a
+  state, it sends the successors to their owners through lock-free message
+  queues. Workers only share the task, the successor generator and the cost
+  of the best plan found so far (incumbent).
+
+  A worker does not stop when it expands a goal state, but keeps expanding
+  states with f < incumbent. The search terminates when all workers are idle
+  and no messages are in transit. With an admissible heuristic, the
+  incumbent plan is then optimal.
+*/
+class HDAStarSearch : public SearchAlgorithm {
+    class Worker;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    // Worker and state of the goal state of the incumbent plan.
+    int goal_worker;
+    StateID goal_state_id;
+    /*
+      Number of busy workers plus number of message batches in transit. The
+      search is finished when this number reaches 0.
+    */
+    std::atomic<int> work_count;
+    std::atomic<bool> timed_out;
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void report_goal(int g, int worker, StateID state_id);
+    void run_worker(Worker &worker, const utils::CountdownTimer &timer);
+    Plan trace_path() const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDAStarSearch(
+        const std::vector<std::shared_ptr<Evaluator>> &evals,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~HDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -1,7 +1,9 @@
 #include "eager_search.h"
 #include "search_common.h"
 
+#include "../parser/decorated_abstract_syntax_tree.h"
 #include "../plugins/plugin.h"
+#include "../utils/parallel.h"
 
 using namespace std;
 
@@ -16,11 +18,22 @@ public:
             "as f-function. "
             "We break ties using the evaluator. Closed nodes are re-opened.");
 
-        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value",
+            "",
+            plugins::Bounds::unlimited(),
+            true);
         add_option<shared_ptr<Evaluator>>(
             "lazy_evaluator",
             "An evaluator that re-evaluates a state before it is expanded.",
             plugins::ArgumentInfo::NO_DEFAULT);
+        add_option<int>(
+            "evaluation_threads",
+            "number of threads that evaluate the new successors of an "
+            "expanded state (0 = one per hardware thread)",
+            "1",
+            plugins::Bounds("0", "infinity"));
         eager_search::add_eager_search_options_to_feature(
             *this, "astar");
 
@@ -30,6 +43,17 @@ public:
             "re-evaluates s. If h(s) changes (for example because h is path-dependent), "
             "s is not expanded, but instead reinserted into the open list. "
             "This option is currently only present for the A* algorithm.");
+        document_note(
+            "evaluation_threads",
+            "With more than one thread, the new successors of every expanded "
+            "state are evaluated in parallel. Every thread uses its own "
+            "instance of the evaluator. If the evaluator supports cloning, "
+            "the instances share the data computed in the preprocessing. "
+            "Otherwise, the evaluator is constructed once per thread and "
+            "must not be predefined with let(). "
+            "The evaluator must be a heuristic that caches its estimates and "
+            "is not path-dependent. The search behaves exactly as with a "
+            "single thread.");
         document_note(
             "Equivalent statements using general eager search",
             "\n```\n--search astar(evaluator)\n```\n"
@@ -42,12 +66,19 @@ public:
 
     virtual shared_ptr<eager_search::EagerSearch> create_component(
         const plugins::Options &opts,
-        const utils::Context &) const override {
+        const utils::Context &context) const override {
         plugins::Options options_copy(opts);
+        int num_threads = utils::get_num_threads(opts.get<int>("evaluation_threads"));
+        vector<shared_ptr<Evaluator>> evals =
+            search_common::create_worker_evaluators(
+                opts.get<parser::LazyValue>("eval"), num_threads, context);
+        vector<vector<shared_ptr<Evaluator>>> parallel_evals;
+        if (num_threads > 1) {
+            parallel_evals.push_back(evals);
+        }
         auto temp =
             search_common::create_astar_open_list_factory_and_f_eval(
-                opts.get<shared_ptr<Evaluator>>("eval"),
-                opts.get<utils::Verbosity>("verbosity"));
+                evals[0], opts.get<utils::Verbosity>("verbosity"));
         options_copy.set("open", temp.first);
         options_copy.set("f_eval", temp.second);
         options_copy.set("reopen_closed", true);
@@ -58,6 +89,7 @@ public:
             options_copy.get<bool>("reopen_closed"),
             options_copy.get<shared_ptr<Evaluator>>("f_eval", nullptr),
             options_copy.get_list<shared_ptr<Evaluator>>("preferred"),
+            parallel_evals,
             eager_search::get_eager_search_arguments_from_options(
                 options_copy)
             );
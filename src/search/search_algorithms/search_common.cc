@@ -1,5 +1,6 @@
 #include "search_common.h"
 
+#include "../evaluator.h"
 #include "../open_list_factory.h"
 
 #include "../evaluators/g_evaluator.h"
@@ -7,8 +8,10 @@
 #include "../evaluators/weighted_evaluator.h"
 #include "../open_lists/alternation_open_list.h"
 #include "../open_lists/best_first_open_list.h"
-#include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/bucket_open_list.h"
+#include "../parser/decorated_abstract_syntax_tree.h"
 
+#include <algorithm>
 #include <memory>
 
 using namespace std;
@@ -112,8 +115,28 @@ create_astar_open_list_factory_and_f_eval(
     vector<shared_ptr<Evaluator>> evals = {f, h_eval};
 
     shared_ptr<OpenListFactory> open =
-        make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(
+        make_shared<bucket_open_list::BucketOpenListFactory>(
             evals, false, false);
     return make_pair(open, f);
 }
+
+vector<shared_ptr<Evaluator>> create_worker_evaluators(
+    const parser::LazyValue &eval_config, int num_workers,
+    const utils::Context &context) {
+    vector<shared_ptr<Evaluator>> evals;
+    evals.push_back(eval_config.construct<shared_ptr<Evaluator>>());
+    for (int i = 1; i < num_workers; ++i) {
+        shared_ptr<Evaluator> eval = evals[0]->clone_for_worker();
+        if (!eval) {
+            eval = eval_config.construct<shared_ptr<Evaluator>>();
+            if (find(evals.begin(), evals.end(), eval) != evals.end()) {
+                context.error(
+                    "The evaluator is used by several threads, but does not "
+                    "support cloning. Do not predefine it with let().");
+            }
+        }
+        evals.push_back(eval);
+    }
+    return evals;
+}
 }
@@ -25,6 +25,10 @@
 class Evaluator;
 class OpenListFactory;
 
+namespace parser {
+class LazyValue;
+}
+
 namespace search_common {
 /*
   Create open list factory for the eager_greedy or lazy_greedy plugins.
@@ -59,14 +63,27 @@ extern std::shared_ptr<OpenListFactory> create_wastar_open_list_factory(
   Create open list factory and f_evaluator (used for displaying progress
   statistics) for A* search.
 
-  The resulting open list factory produces a tie-breaking open list
-  ordered primarily on g + h and secondarily on h.
+  The resulting open list factory produces a bucket open list ordered
+  primarily on g + h and secondarily on h, with ties broken in FIFO order.
 */
 extern std::pair<std::shared_ptr<OpenListFactory>,
                  const std::shared_ptr<Evaluator>>
 create_astar_open_list_factory_and_f_eval(
     const std::shared_ptr<Evaluator> &h_eval,
     utils::Verbosity verbosity);
+
+/*
+  Create num_workers instances of an evaluator for threads that evaluate
+  states concurrently. The first instance is constructed from eval_config,
+  the others are clones of it (see Evaluator::clone_for_worker) that share
+  its precomputed data. If the evaluator does not support cloning, every
+  instance is constructed from eval_config. This is reported as an error
+  if the evaluator is predefined with let(), since the instances would
+  then be the same object.
+*/
+extern std::vector<std::shared_ptr<Evaluator>> create_worker_evaluators(
+    const parser::LazyValue &eval_config, int num_workers,
+    const utils::Context &context);
 }
 
 #endif
@@ -1,10 +1,26 @@
 #include "search_node_info.h"
 
-static const int pointer_bytes = sizeof(void *);
-static const int info_bytes = 3 * sizeof(int) + sizeof(StateID);
-static const int padding_bytes = info_bytes % pointer_bytes;
+using namespace std;
 
-static_assert(
-    sizeof(SearchNodeInfo) == info_bytes + padding_bytes,
-    "The size of SearchNodeInfo is larger than expected. This probably means "
-    "that packing two fields into one integer using bitfields is not supported.");
+SearchNodeInfoLayout::SearchNodeInfoLayout(bool store_real_g, bool store_parents)
+    : real_g_index(-1),
+      parent_index(-1),
+      num_ints(1) {
+    if (store_real_g) {
+        real_g_index = num_ints++;
+    }
+    if (store_parents) {
+        parent_index = num_ints;
+        num_ints += 2;
+    }
+}
+
+vector<int> SearchNodeInfoLayout::get_default_values() const {
+    vector<int> values(num_ints);
+    SearchNodeInfo info(values.data(), *this);
+    info.set_status(SearchNodeInfo::NEW);
+    info.set_g(-1);
+    info.set_real_g(-1);
+    info.set_parent(StateID::no_state, OperatorID::no_operator);
+    return values;
+}
@@ -4,21 +4,104 @@
 #include "operator_id.h"
 #include "state_id.h"
 
+#include <cassert>
+#include <vector>
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
-struct SearchNodeInfo {
+/*
+  The search information of a state is stored as a fixed number of ints.
+  The search space decides once which fields it stores:
+  - the status and the g value are packed into one int and always stored,
+  - real_g (the g value with the original operator costs) is only stored
+    if the search uses adjusted costs, otherwise it equals g,
+  - the parent state and the creating operator are only stored if the
+    search space keeps parent pointers.
+  Depending on the layout, a state needs 4 to 16 bytes.
+*/
+struct SearchNodeInfoLayout {
+    // Index of real_g, or -1 if real_g is not stored.
+    int real_g_index;
+    // Index of the parent state ID, or -1 if there are no parent pointers.
+    // The creating operator is stored after the parent state ID.
+    int parent_index;
+    int num_ints;
+
+    SearchNodeInfoLayout(bool store_real_g, bool store_parents);
+
+    std::vector<int> get_default_values() const;
+};
+
+class SearchNodeInfo {
+public:
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
 
-    unsigned int status : 2;
-    int g : 30;
-    StateID parent_state_id;
-    OperatorID creating_operator;
-    int real_g;
+private:
+    static const int STATUS_BITS = 2;
+    static const int STATUS_MASK = (1 << STATUS_BITS) - 1;
+
+    int *data;
+    const SearchNodeInfoLayout *layout;
+
+public:
+    SearchNodeInfo(int *data, const SearchNodeInfoLayout &layout)
+        : data(data), layout(&layout) {
+    }
+
+    NodeStatus get_status() const {
+        return static_cast<NodeStatus>(data[0] & STATUS_MASK);
+    }
+
+    void set_status(NodeStatus status) {
+        data[0] = (data[0] & ~STATUS_MASK) | status;
+    }
+
+    // Like the former 30-bit field, g is stored in the upper bits.
+    int get_g() const {
+        return data[0] >> STATUS_BITS;
+    }
+
+    void set_g(int g) {
+        assert(g >= -1 && g < (1 << (31 - STATUS_BITS)));
+        data[0] = static_cast<int>(static_cast<unsigned int>(g) << STATUS_BITS) |
+                  (data[0] & STATUS_MASK);
+    }
+
+    int get_real_g() const {
+        if (layout->real_g_index == -1) {
+            return get_g();
+        }
+        return data[layout->real_g_index];
+    }
+
+    void set_real_g(int real_g) {
+        if (layout->real_g_index == -1) {
+            assert(real_g == get_g());
+        } else {
+            data[layout->real_g_index] = real_g;
+        }
+    }
+
+    bool has_parent_pointers() const {
+        return layout->parent_index != -1;
+    }
+
+    StateID get_parent_state_id() const {
+        assert(has_parent_pointers());
+        return StateID(data[layout->parent_index]);
+    }
+
+    OperatorID get_creating_operator() const {
+        assert(has_parent_pointers());
+        return OperatorID(data[layout->parent_index + 1]);
+    }
 
-    SearchNodeInfo()
-        : status(NEW), g(-1), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+    void set_parent(StateID parent_state_id, OperatorID creating_operator) {
+        if (has_parent_pointers()) {
+            data[layout->parent_index] = parent_state_id.value;
+            data[layout->parent_index + 1] = creating_operator.get_index();
+        }
     }
 };
 
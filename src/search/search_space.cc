@@ -5,12 +5,14 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
+SearchNode::SearchNode(const State &state, const SearchNodeInfo &info)
     : state(state), info(info) {
     assert(state.get_id() != StateID::no_state);
 }
@@ -20,141 +22,380 @@ const State &SearchNode::get_state() const {
 }
 
 bool SearchNode::is_open() const {
-    return info.status == SearchNodeInfo::OPEN;
+    return info.get_status() == SearchNodeInfo::OPEN;
 }
 
 bool SearchNode::is_closed() const {
-    return info.status == SearchNodeInfo::CLOSED;
+    return info.get_status() == SearchNodeInfo::CLOSED;
 }
 
 bool SearchNode::is_dead_end() const {
-    return info.status == SearchNodeInfo::DEAD_END;
+    return info.get_status() == SearchNodeInfo::DEAD_END;
 }
 
 bool SearchNode::is_new() const {
-    return info.status == SearchNodeInfo::NEW;
+    return info.get_status() == SearchNodeInfo::NEW;
 }
 
 int SearchNode::get_g() const {
-    assert(info.g >= 0);
-    return info.g;
+    assert(info.get_g() >= 0);
+    return info.get_g();
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    return info.get_real_g();
 }
 
 void SearchNode::open_initial() {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = 0;
-    info.real_g = 0;
-    info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    assert(info.get_status() == SearchNodeInfo::NEW);
+    info.set_status(SearchNodeInfo::OPEN);
+    info.set_g(0);
+    info.set_real_g(0);
+    info.set_parent(StateID::no_state, OperatorID::no_operator);
 }
 
 void SearchNode::update_parent(const SearchNode &parent_node,
                                const OperatorProxy &parent_op,
                                int adjusted_cost) {
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    info.set_g(parent_node.info.get_g() + adjusted_cost);
+    info.set_real_g(parent_node.info.get_real_g() + parent_op.get_cost());
+    info.set_parent(parent_node.get_state().get_id(),
+                    OperatorID(parent_op.get_id()));
 }
 
 void SearchNode::open_new_node(const SearchNode &parent_node,
                                const OperatorProxy &parent_op,
                                int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
+    assert(info.get_status() == SearchNodeInfo::NEW);
+    info.set_status(SearchNodeInfo::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen_closed_node(const SearchNode &parent_node,
                                     const OperatorProxy &parent_op,
                                     int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::CLOSED);
-    info.status = SearchNodeInfo::OPEN;
+    assert(info.get_status() == SearchNodeInfo::CLOSED);
+    info.set_status(SearchNodeInfo::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::update_open_node_parent(const SearchNode &parent_node,
                                          const OperatorProxy &parent_op,
                                          int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN);
+    assert(info.get_status() == SearchNodeInfo::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::update_closed_node_parent(const SearchNode &parent_node,
                                            const OperatorProxy &parent_op,
                                            int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::CLOSED);
+    assert(info.get_status() == SearchNodeInfo::CLOSED);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::close() {
-    assert(info.status == SearchNodeInfo::OPEN);
-    info.status = SearchNodeInfo::CLOSED;
+    assert(info.get_status() == SearchNodeInfo::OPEN);
+    info.set_status(SearchNodeInfo::CLOSED);
 }
 
 void SearchNode::mark_as_dead_end() {
-    info.status = SearchNodeInfo::DEAD_END;
+    info.set_status(SearchNodeInfo::DEAD_END);
 }
 
 void SearchNode::dump(const TaskProxy &task_proxy, utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         log << state.get_id() << ": ";
         task_properties::dump_fdr(state);
-        if (info.creating_operator != OperatorID::no_operator) {
+        if (!info.has_parent_pointers()) {
+            log << " parent not stored" << endl;
+        } else if (info.get_creating_operator() != OperatorID::no_operator) {
             OperatorsProxy operators = task_proxy.get_operators();
-            OperatorProxy op = operators[info.creating_operator.get_index()];
+            OperatorProxy op = operators[info.get_creating_operator().get_index()];
             log << " created by " << op.get_name()
-                << " from " << info.parent_state_id << endl;
+                << " from " << info.get_parent_state_id() << endl;
         } else {
             log << " no parent" << endl;
         }
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log)
-    : state_registry(state_registry), log(log) {
+SearchSpace::SearchSpace(StateRegistry &state_registry, OperatorCost cost_type,
+                         utils::LogProxy &log)
+    : cost_type(cost_type),
+      is_unit_cost(task_properties::is_unit_cost(state_registry.get_task_proxy())),
+      layout(cost_type != OperatorCost::NORMAL, true),
+      search_node_infos(make_unique<PerStateArray<int>>(
+                            layout.get_default_values())),
+      state_registry(state_registry),
+      log(log) {
+}
+
+void SearchSpace::set_store_parents(bool store_parents) {
+    if (!store_parents) {
+        TaskProxy task_proxy = state_registry.get_task_proxy();
+        task_properties::verify_no_axioms(task_proxy);
+        task_properties::verify_no_conditional_effects(task_proxy);
+    }
+    layout = SearchNodeInfoLayout(layout.real_g_index != -1, store_parents);
+    search_node_infos = make_unique<PerStateArray<int>>(
+        layout.get_default_values());
+}
+
+SearchNodeInfo SearchSpace::get_info(const State &state) {
+    return SearchNodeInfo(&(*search_node_infos)[state][0], layout);
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    return SearchNode(state, get_info(state));
 }
 
 void SearchSpace::trace_path(const State &goal_state,
-                             vector<OperatorID> &path) const {
+                             vector<OperatorID> &path) {
     State current_state = goal_state;
     assert(current_state.get_registry() == &state_registry);
     assert(path.empty());
+    if (layout.parent_index == -1) {
+        trace_path_by_regression(goal_state, path);
+        return;
+    }
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        SearchNodeInfo info = get_info(current_state);
+        if (info.get_creating_operator() == OperatorID::no_operator) {
+            assert(info.get_parent_state_id() == StateID::no_state);
             break;
         }
-        path.push_back(info.creating_operator);
-        current_state = state_registry.lookup_state(info.parent_state_id);
+        path.push_back(info.get_creating_operator());
+        current_state = state_registry.lookup_state(info.get_parent_state_id());
     }
     reverse(path.begin(), path.end());
 }
 
+/*
+  Returns the sorted values that each variable has in at least one reached
+  state.
+*/
+vector<vector<int>> SearchSpace::get_reached_values() const {
+    VariablesProxy variables = state_registry.get_task_proxy().get_variables();
+    vector<vector<bool>> is_reached;
+    is_reached.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        is_reached.emplace_back(var.get_domain_size(), false);
+    }
+    for (StateID id : state_registry) {
+        State state = state_registry.lookup_state(id);
+        state.unpack();
+        const vector<int> &values = state.get_unpacked_values();
+        for (size_t var = 0; var < values.size(); ++var) {
+            is_reached[var][values[var]] = true;
+        }
+    }
+    vector<vector<int>> reached_values(variables.size());
+    for (size_t var = 0; var < is_reached.size(); ++var) {
+        for (size_t value = 0; value < is_reached[var].size(); ++value) {
+            if (is_reached[var][value]) {
+                reached_values[var].push_back(value);
+            }
+        }
+    }
+    return reached_values;
+}
+
+/*
+  Returns the open or closed states p and operators o such that applying o
+  in p leads to the given state and g(p) + cost(o) <= g(state), ordered by
+  g(p). Dead ends are skipped: their g value is never set and they cannot
+  be on the path to a goal.
+  Variables that an operator changes without a precondition can have any
+  value in p. For them, we only try the values in reached_values.
+*/
+vector<pair<State, OperatorID>> SearchSpace::get_predecessors(
+    const State &state, const vector<vector<int>> &reached_values) {
+    /*
+      Limit on the number of candidate predecessors per operator. It is
+      only reached if operators change many variables without a
+      precondition, each of which has many reached values.
+    */
+    const double max_candidates = 1e6;
+    const TaskProxy &task_proxy = state_registry.get_task_proxy();
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    int g = get_info(state).get_g();
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+
+    vector<pair<State, OperatorID>> predecessors;
+    vector<int> predecessor_values;
+    vector<int> free_vars;
+    // Index into reached_values for each free variable.
+    vector<size_t> free_value_indices;
+    vector<PackedStateBin> buffer(state_packer.get_num_bins());
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int cost = get_adjusted_action_cost(op, cost_type, is_unit_cost);
+        if (cost > g) {
+            continue;
+        }
+        EffectsProxy effects = op.get_effects();
+        bool consistent = true;
+        for (EffectProxy effect : effects) {
+            FactPair fact = effect.get_fact().get_pair();
+            if (values[fact.var] != fact.value) {
+                consistent = false;
+                break;
+            }
+        }
+        if (!consistent) {
+            continue;
+        }
+        /*
+          Variables without effect keep their value. Variables with an
+          effect have the value of their precondition or any value if
+          there is none.
+        */
+        predecessor_values = values;
+        free_vars.clear();
+        for (EffectProxy effect : effects) {
+            int var = effect.get_fact().get_variable().get_id();
+            predecessor_values[var] = -1;
+        }
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            if (predecessor_values[fact.var] == -1) {
+                predecessor_values[fact.var] = fact.value;
+            } else if (values[fact.var] != fact.value) {
+                consistent = false;
+                break;
+            }
+        }
+        if (!consistent) {
+            continue;
+        }
+        double num_candidates = 1;
+        for (EffectProxy effect : effects) {
+            int var = effect.get_fact().get_variable().get_id();
+            if (predecessor_values[var] == -1) {
+                if (reached_values[var].empty()) {
+                    consistent = false;
+                    break;
+                }
+                free_vars.push_back(var);
+                predecessor_values[var] = reached_values[var][0];
+                num_candidates *= reached_values[var].size();
+            }
+        }
+        if (!consistent) {
+            continue;
+        }
+        if (num_candidates > max_candidates) {
+            cerr << "Could not recover the plan without parent pointers: "
+                 << "operator " << op.get_name() << " has " << num_candidates
+                 << " candidate predecessors. Use store_parents=true for this task."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        free_value_indices.assign(free_vars.size(), 0);
+        // Enumerate all assignments of reached values to the free variables.
+        for (;;) {
+            state_packer.pack_all(predecessor_values.data(), buffer.data());
+            StateID id = state_registry.find_state_id(buffer.data());
+            if (id != StateID::no_state) {
+                State predecessor = state_registry.lookup_state(id);
+                SearchNodeInfo info = get_info(predecessor);
+                SearchNodeInfo::NodeStatus status = info.get_status();
+                if ((status == SearchNodeInfo::OPEN ||
+                     status == SearchNodeInfo::CLOSED) &&
+                    info.get_g() + cost <= g) {
+                    predecessors.emplace_back(
+                        move(predecessor), OperatorID(op.get_id()));
+                }
+            }
+            size_t i = 0;
+            for (; i < free_vars.size(); ++i) {
+                const vector<int> &var_values = reached_values[free_vars[i]];
+                if (++free_value_indices[i] < var_values.size()) {
+                    predecessor_values[free_vars[i]] = var_values[free_value_indices[i]];
+                    break;
+                }
+                free_value_indices[i] = 0;
+                predecessor_values[free_vars[i]] = var_values[0];
+            }
+            if (i == free_vars.size()) {
+                break;
+            }
+        }
+    }
+    sort(predecessors.begin(), predecessors.end(),
+         [this](const pair<State, OperatorID> &lhs,
+                const pair<State, OperatorID> &rhs) {
+             return get_info(lhs.first).get_g() < get_info(rhs.first).get_g();
+         });
+    return predecessors;
+}
+
+/*
+  Every reached state s other than the initial state has a predecessor
+  returned by get_predecessors: the parent p from which g(s) was last set
+  had g(p) + cost(o) = g(s) at that time, and g values never increase.
+  We search depth-first from the goal state to the initial state and
+  prefer predecessors with low g values. Visited states are skipped to
+  avoid cycles of zero-cost operators.
+*/
+void SearchSpace::trace_path_by_regression(
+    const State &goal_state, vector<OperatorID> &path) {
+    struct Frame {
+        State state;
+        vector<pair<State, OperatorID>> predecessors;
+        size_t next_predecessor;
+    };
+
+    StateID initial_state_id = state_registry.get_initial_state().get_id();
+    vector<vector<int>> reached_values = get_reached_values();
+    PerStateInformation<bool> visited(false);
+    visited[goal_state] = true;
+    vector<Frame> stack;
+    stack.push_back({goal_state, get_predecessors(goal_state, reached_values), 0});
+    while (stack.back().state.get_id() != initial_state_id) {
+        Frame &frame = stack.back();
+        if (frame.next_predecessor == frame.predecessors.size()) {
+            stack.pop_back();
+            if (stack.empty()) {
+                cerr << "Could not recover the plan without parent pointers."
+                     << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+            continue;
+        }
+        State predecessor =
+            frame.predecessors[frame.next_predecessor++].first;
+        if (!visited[predecessor]) {
+            visited[predecessor] = true;
+            vector<pair<State, OperatorID>> predecessors =
+                get_predecessors(predecessor, reached_values);
+            stack.push_back({move(predecessor), move(predecessors), 0});
+        }
+    }
+    for (auto it = stack.rbegin() + 1; it != stack.rend(); ++it) {
+        path.push_back(it->predecessors[it->next_predecessor - 1].second);
+    }
+}
+
 void SearchSpace::dump(const TaskProxy &task_proxy) const {
     OperatorsProxy operators = task_proxy.get_operators();
     for (StateID id : state_registry) {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         State state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const PerStateArray<int> &infos = *search_node_infos;
+        ConstArrayView<int> data = infos[state];
+        // The info is only read.
+        const SearchNodeInfo node_info(const_cast<int *>(&data[0]), layout);
         log << id << ": ";
         task_properties::dump_fdr(state);
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
-            OperatorProxy op = operators[node_info.creating_operator.get_index()];
+        if (!node_info.has_parent_pointers()) {
+            log << " parent not stored" << endl;
+        } else if (node_info.get_creating_operator() != OperatorID::no_operator &&
+                   node_info.get_parent_state_id() != StateID::no_state) {
+            OperatorProxy op = operators[node_info.get_creating_operator().get_index()];
             log << " created by " << op.get_name()
-                << " from " << node_info.parent_state_id << endl;
+                << " from " << node_info.get_parent_state_id() << endl;
         } else {
             log << "has no parent" << endl;
         }
@@ -2,9 +2,11 @@
 #define SEARCH_SPACE_H
 
 #include "operator_cost.h"
-#include "per_state_information.h"
+#include "per_state_array.h"
 #include "search_node_info.h"
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 class OperatorProxy;
@@ -17,13 +19,13 @@ class LogProxy;
 
 class SearchNode {
     State state;
-    SearchNodeInfo &info;
+    SearchNodeInfo info;
 
     void update_parent(const SearchNode &parent_node,
                        const OperatorProxy &parent_op,
                        int adjusted_cost);
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(const State &state, const SearchNodeInfo &info);
 
     const State &get_state() const;
 
@@ -56,16 +58,40 @@ public:
 
 
 class SearchSpace {
-    PerStateInformation<SearchNodeInfo> search_node_infos;
+    const OperatorCost cost_type;
+    const bool is_unit_cost;
+    SearchNodeInfoLayout layout;
+    std::unique_ptr<PerStateArray<int>> search_node_infos;
 
     StateRegistry &state_registry;
     utils::LogProxy &log;
+
+    SearchNodeInfo get_info(const State &state);
+    std::vector<std::vector<int>> get_reached_values() const;
+    std::vector<std::pair<State, OperatorID>> get_predecessors(
+        const State &state,
+        const std::vector<std::vector<int>> &reached_values);
+    void trace_path_by_regression(const State &goal_state,
+                                  std::vector<OperatorID> &path);
 public:
-    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
+    /*
+      real_g is only stored if the cost type is not NORMAL, since it
+      equals g otherwise.
+    */
+    SearchSpace(StateRegistry &state_registry, OperatorCost cost_type,
+                utils::LogProxy &log);
+
+    /*
+      Without parent pointers, trace_path regresses from the goal state
+      over the reached states. This is only supported for tasks without
+      axioms and conditional effects. Must be called before the first node
+      is accessed.
+    */
+    void set_store_parents(bool store_parents);
 
     SearchNode get_node(const State &state);
     void trace_path(const State &goal_state,
-                    std::vector<OperatorID> &path) const;
+                    std::vector<OperatorID> &path);
 
     void dump(const TaskProxy &task_proxy) const;
     void print_statistics() const;
@@ -6,9 +6,310 @@
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
 
+#include <limits>
+#include <mutex>
+
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+/*
+  Hash set of StateIDs and state data pool of a thread-safe registry. Each
+  stripe is an IntHashSet protected by its own mutex. The stripe of a state is
+  selected by the high bits of its hash, the IntHashSet uses the low bits.
+
+  To look up a state that is not in the pool yet, we let the hasher and
+  equality tester of the stripe interpret PROBE_KEY as the buffer of the
+  state that is currently looked up in this stripe. Only new states are
+  added to the pool, so there are no gaps in the IDs.
+*/
+class StateRegistry::ConcurrentStateSet {
+    static const int LOG_NUM_STRIPES = 6;
+    static const int PROBE_KEY = numeric_limits<int>::max();
+
+    using StatePool = segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>;
+
+    struct Probe {
+        const PackedStateBin *buffer = nullptr;
+        int_hash_set::HashType hash = 0;
+    };
+
+    struct ProbeHash {
+        const StatePool &state_data_pool;
+        const Probe &probe;
+        int state_size;
+
+        int_hash_set::HashType operator()(int id) const {
+            if (id == PROBE_KEY) {
+                return probe.hash;
+            }
+            return get_packed_state_hash(state_data_pool[id], state_size);
+        }
+    };
+
+    struct ProbeEqual {
+        const StatePool &state_data_pool;
+        const Probe &probe;
+        int state_size;
+
+        const PackedStateBin *get_data(int id) const {
+            return id == PROBE_KEY ? probe.buffer : state_data_pool[id];
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = get_data(lhs);
+            return equal(lhs_data, lhs_data + state_size, get_data(rhs));
+        }
+    };
+
+    struct Stripe {
+        mutex stripe_mutex;
+        Probe probe;
+        int_hash_set::IntHashSet<ProbeHash, ProbeEqual> ids;
+
+        Stripe(const StatePool &state_data_pool, int state_size)
+            : ids(ProbeHash{state_data_pool, probe, state_size},
+                  ProbeEqual{state_data_pool, probe, state_size}) {
+        }
+    };
+
+    const int state_size;
+    StatePool state_data_pool;
+    vector<unique_ptr<Stripe>> stripes;
+public:
+    explicit ConcurrentStateSet(int state_size)
+        : state_size(state_size),
+          state_data_pool(state_size) {
+        stripes.reserve(1 << LOG_NUM_STRIPES);
+        for (int i = 0; i < (1 << LOG_NUM_STRIPES); ++i) {
+            stripes.push_back(make_unique<Stripe>(state_data_pool, state_size));
+        }
+    }
+
+    StateID find(const PackedStateBin *buffer) {
+        int_hash_set::HashType hash = get_packed_state_hash(buffer, state_size);
+        Stripe &stripe = *stripes[hash >> (32 - LOG_NUM_STRIPES)];
+        lock_guard<mutex> lock(stripe.stripe_mutex);
+        stripe.probe.buffer = buffer;
+        stripe.probe.hash = hash;
+        int id = stripe.ids.find(PROBE_KEY);
+        return id == -1 ? StateID::no_state : StateID(id);
+    }
+
+    StateID insert(const PackedStateBin *buffer) {
+        int_hash_set::HashType hash = get_packed_state_hash(buffer, state_size);
+        Stripe &stripe = *stripes[hash >> (32 - LOG_NUM_STRIPES)];
+        lock_guard<mutex> lock(stripe.stripe_mutex);
+        stripe.probe.buffer = buffer;
+        stripe.probe.hash = hash;
+        int id = stripe.ids.find(PROBE_KEY);
+        if (id == -1) {
+            size_t new_id = state_data_pool.push_back(buffer);
+            if (new_id >= static_cast<size_t>(PROBE_KEY)) {
+                cerr << "Thread-safe state registry surpassed maximum number "
+                     << "of states. Aborting." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+            id = new_id;
+            stripe.ids.insert(id);
+        }
+        return StateID(id);
+    }
+
+    const PackedStateBin *lookup(StateID id) const {
+        return state_data_pool[id.value];
+    }
+
+    size_t size() const {
+        return state_data_pool.size();
+    }
+
+    int get_num_stripes() const {
+        return stripes.size();
+    }
+};
+
+/*
+  Tree-compressed state storage (see state_registry.h). Roots and inner nodes
+  are pairs of bins that are interned in separate node tables, so that the
+  index of a root is the ID of its state. Both tables compare their pairs
+  semantically like the uncompressed registry compares states.
+
+  The leaves of the subtree for the bins [begin, end) are split at
+  begin + (end - begin) / 2. A child that covers a single bin stores the bin
+  itself.
+*/
+class StateRegistry::CompressedStateSet {
+    static const int LOG_CACHE_SIZE = 10;
+
+    using NodePool = segmented_vector::SegmentedArrayVector<PackedStateBin>;
+
+    struct NodeHash {
+        const NodePool &pool;
+
+        int_hash_set::HashType operator()(int id) const {
+            return get_packed_state_hash(pool[id], 2);
+        }
+    };
+
+    struct NodeEqual {
+        const NodePool &pool;
+
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = pool[lhs];
+            return equal(lhs_data, lhs_data + 2, pool[rhs]);
+        }
+    };
+
+    class NodeTable {
+        NodePool pool;
+        int_hash_set::IntHashSet<NodeHash, NodeEqual> ids;
+    public:
+        NodeTable()
+            : pool(2),
+              ids(NodeHash{pool}, NodeEqual{pool}) {
+        }
+
+        // Returns the index of the node and whether it was added.
+        pair<int, bool> insert(const PackedStateBin *node) {
+            pool.push_back(node);
+            pair<int, bool> result = ids.insert(pool.size() - 1);
+            if (!result.second) {
+                pool.pop_back();
+            }
+            return result;
+        }
+
+        // Returns the index of the node or -1 if it is not in the table.
+        int find(const PackedStateBin *node) {
+            pool.push_back(node);
+            int id = ids.find(pool.size() - 1);
+            pool.pop_back();
+            return id;
+        }
+
+        const PackedStateBin *operator[](int id) const {
+            return pool[id];
+        }
+
+        size_t size() const {
+            return pool.size();
+        }
+    };
+
+    struct CacheEntry {
+        StateID id = StateID::no_state;
+        shared_ptr<vector<PackedStateBin>> data;
+    };
+
+    const int state_size;
+    NodeTable roots;
+    NodeTable inner_nodes;
+    mutable vector<CacheEntry> cache;
+
+    /*
+      Computes the reference for the bins [begin, end) of buffer. If
+      insert_nodes is false, no nodes are added and the result is false if a
+      node is missing.
+    */
+    bool compress(const PackedStateBin *buffer, int begin, int end,
+                  bool insert_nodes, PackedStateBin &ref) {
+        if (end - begin == 1) {
+            ref = buffer[begin];
+            return true;
+        }
+        PackedStateBin node[2];
+        if (!compress_children(buffer, begin, end, insert_nodes, node)) {
+            return false;
+        }
+        int id = insert_nodes ? inner_nodes.insert(node).first
+            : inner_nodes.find(node);
+        ref = id;
+        return id != -1;
+    }
+
+    bool compress_children(const PackedStateBin *buffer, int begin, int end,
+                           bool insert_nodes, PackedStateBin *node) {
+        int mid = begin + (end - begin) / 2;
+        return compress(buffer, begin, mid, insert_nodes, node[0]) &&
+               compress(buffer, mid, end, insert_nodes, node[1]);
+    }
+
+    void decompress(PackedStateBin ref, int begin, int end,
+                    PackedStateBin *buffer) const {
+        if (end - begin == 1) {
+            buffer[begin] = ref;
+        } else {
+            decompress_children(inner_nodes[ref], begin, end, buffer);
+        }
+    }
+
+    void decompress_children(const PackedStateBin *node, int begin, int end,
+                             PackedStateBin *buffer) const {
+        int mid = begin + (end - begin) / 2;
+        decompress(node[0], begin, mid, buffer);
+        decompress(node[1], mid, end, buffer);
+    }
+
+    /*
+      Returns a cache slot for the state that no State object refers to
+      anymore.
+    */
+    CacheEntry &get_free_cache_entry(StateID id) const {
+        CacheEntry &entry = cache[id.value & ((1 << LOG_CACHE_SIZE) - 1)];
+        if (!entry.data || entry.data.use_count() > 1) {
+            entry.data = make_shared<vector<PackedStateBin>>(state_size);
+        }
+        entry.id = id;
+        return entry;
+    }
+public:
+    explicit CompressedStateSet(int state_size)
+        : state_size(state_size),
+          cache(1 << LOG_CACHE_SIZE) {
+        assert(state_size >= 2);
+    }
+
+    StateID find(const PackedStateBin *buffer) {
+        PackedStateBin root[2];
+        if (!compress_children(buffer, 0, state_size, false, root)) {
+            return StateID::no_state;
+        }
+        int id = roots.find(root);
+        return id == -1 ? StateID::no_state : StateID(id);
+    }
+
+    StateID insert(const PackedStateBin *buffer) {
+        PackedStateBin root[2];
+        compress_children(buffer, 0, state_size, true, root);
+        pair<int, bool> result = roots.insert(root);
+        StateID id(result.first);
+        if (result.second) {
+            // New states are usually looked up right away.
+            CacheEntry &entry = get_free_cache_entry(id);
+            copy(buffer, buffer + state_size, entry.data->begin());
+        }
+        return id;
+    }
+
+    shared_ptr<const vector<PackedStateBin>> lookup(StateID id) const {
+        CacheEntry &entry = cache[id.value & ((1 << LOG_CACHE_SIZE) - 1)];
+        if (entry.id != id) {
+            get_free_cache_entry(id);
+            decompress_children(
+                roots[id.value], 0, state_size, entry.data->data());
+        }
+        return entry.data;
+    }
+
+    size_t size() const {
+        return roots.size();
+    }
+
+    size_t get_num_inner_nodes() const {
+        return inner_nodes.size();
+    }
+};
+
+StateRegistry::StateRegistry(const TaskProxy &task_proxy, bool thread_safe)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
@@ -17,6 +318,12 @@ StateRegistry::StateRegistry(const TaskProxy &task_proxy)
       registered_states(
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+    if (thread_safe) {
+        concurrent_states = make_unique<ConcurrentStateSet>(get_bins_per_state());
+    }
+}
+
+StateRegistry::~StateRegistry() {
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -36,31 +343,124 @@ StateID StateRegistry::insert_id_or_pop_state() {
     return StateID(result.first);
 }
 
+const PackedStateBin *StateRegistry::get_state_data(StateID id) const {
+    assert(!compressed_states);
+    if (concurrent_states) {
+        return concurrent_states->lookup(id);
+    }
+    return state_data_pool[id.value];
+}
+
+StateID StateRegistry::insert_state_from_buffer(const PackedStateBin *buffer) {
+    if (concurrent_states) {
+        return concurrent_states->insert(buffer);
+    }
+    assert(compressed_states);
+    return compressed_states->insert(buffer);
+}
+
+size_t StateRegistry::get_num_concurrent_states() const {
+    return concurrent_states->size();
+}
+
+size_t StateRegistry::get_num_compressed_states() const {
+    return compressed_states->size();
+}
+
+bool StateRegistry::enable_state_compression() {
+    if (size() != 0) {
+        cerr << "State compression must be enabled before registering "
+             << "states." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    if (concurrent_states) {
+        cerr << "Thread-safe state registries do not support state "
+             << "compression." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (state_data_arena) {
+        cerr << "Disk-backed state registries do not support state "
+             << "compression." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (get_bins_per_state() > 2 && !compressed_states) {
+        compressed_states = make_unique<CompressedStateSet>(
+            get_bins_per_state());
+    }
+    return compressed_states != nullptr;
+}
+
+void StateRegistry::store_states_on_disk(
+    const string &directory, int ram_budget_in_mb) {
+    if (size() != 0) {
+        cerr << "Disk storage must be enabled before registering states."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    if (concurrent_states || compressed_states) {
+        cerr << "Thread-safe and compressed state registries do not support "
+             << "disk storage." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    assert(ram_budget_in_mb >= 0);
+    state_data_arena = make_shared<utils::MappedFileArena>(
+        directory, static_cast<size_t>(ram_budget_in_mb) * 1024 * 1024);
+    state_data_pool.set_allocator(
+        utils::MappedFileAllocator<PackedStateBin>(state_data_arena));
+}
+
 State StateRegistry::lookup_state(StateID id) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+    if (compressed_states) {
+        return task_proxy.create_state(
+            *this, id, compressed_states->lookup(id));
+    }
+    const PackedStateBin *buffer = get_state_data(id);
     return task_proxy.create_state(*this, id, buffer);
 }
 
 State StateRegistry::lookup_state(
     StateID id, vector<int> &&state_values) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+    if (compressed_states) {
+        return task_proxy.create_state(
+            *this, id, compressed_states->lookup(id), move(state_values));
+    }
+    const PackedStateBin *buffer = get_state_data(id);
     return task_proxy.create_state(*this, id, buffer, move(state_values));
 }
 
+State StateRegistry::register_state(const PackedStateBin *buffer) {
+    if (concurrent_states || compressed_states) {
+        return lookup_state(insert_state_from_buffer(buffer));
+    }
+    state_data_pool.push_back(buffer);
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
+StateID StateRegistry::find_state_id(const PackedStateBin *buffer) {
+    if (concurrent_states) {
+        return concurrent_states->find(buffer);
+    } else if (compressed_states) {
+        return compressed_states->find(buffer);
+    }
+    // Look up a temporary copy at the end of the pool.
+    state_data_pool.push_back(buffer);
+    int id = registered_states.find(state_data_pool.size() - 1);
+    state_data_pool.pop_back();
+    return id == -1 ? StateID::no_state : StateID(id);
+}
+
 const State &StateRegistry::get_initial_state() {
     if (!cached_initial_state) {
         int num_bins = get_bins_per_state();
         unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
-        // Avoid garbage values in half-full bins.
-        fill_n(buffer.get(), num_bins, 0);
 
         State initial_state = task_proxy.get_initial_state();
-        for (size_t i = 0; i < initial_state.size(); ++i) {
-            state_packer.set(buffer.get(), i, initial_state[i].get_value());
-        }
-        state_data_pool.push_back(buffer.get());
-        StateID id = insert_id_or_pop_state();
-        cached_initial_state = utils::make_unique_ptr<State>(lookup_state(id));
+        initial_state.unpack();
+        state_packer.pack_all(
+            initial_state.get_unpacked_values().data(), buffer.get());
+        cached_initial_state = utils::make_unique_ptr<State>(
+            register_state(buffer.get()));
     }
     return *cached_initial_state;
 }
@@ -70,6 +470,9 @@ const State &StateRegistry::get_initial_state() {
 //     operating on state buffers (PackedStateBin *).
 State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
+    if (concurrent_states || compressed_states) {
+        return get_successor_state_from_buffer(predecessor, op);
+    }
     /*
       TODO: ideally, we would not modify state_data_pool here and in
       insert_id_or_pop_state, but only at one place, to avoid errors like
@@ -90,9 +493,7 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
             }
         }
         axiom_evaluator.evaluate(new_values);
-        for (size_t i = 0; i < new_values.size(); ++i) {
-            state_packer.set(buffer, i, new_values[i]);
-        }
+        state_packer.pack_all(new_values.data(), buffer);
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
@@ -115,6 +516,50 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
     }
 }
 
+State StateRegistry::get_successor_state_from_buffer(
+    const State &predecessor, const OperatorProxy &op) {
+    /*
+      For registries that do not store states in state_data_pool, the
+      successor is built in a buffer of the calling thread, and only
+      stored if it is new.
+    */
+    static thread_local vector<PackedStateBin> buffer;
+    const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+    buffer.assign(predecessor_buffer, predecessor_buffer + get_bins_per_state());
+    if (task_properties::has_axioms(task_proxy)) {
+        predecessor.unpack();
+        vector<int> new_values = predecessor.get_unpacked_values();
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                new_values[effect_pair.var] = effect_pair.value;
+            }
+        }
+        {
+            /*
+              The axiom evaluator is shared by all registries of the task.
+              Locking is only needed for thread-safe registries, but cheap
+              compared to the evaluation.
+            */
+            static mutex axiom_mutex;
+            lock_guard<mutex> lock(axiom_mutex);
+            axiom_evaluator.evaluate(new_values);
+        }
+        state_packer.pack_all(new_values.data(), buffer.data());
+        StateID id = insert_state_from_buffer(buffer.data());
+        return lookup_state(id, move(new_values));
+    } else {
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(buffer.data(), effect_pair.var, effect_pair.value);
+            }
+        }
+        StateID id = insert_state_from_buffer(buffer.data());
+        return lookup_state(id);
+    }
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -125,5 +570,22 @@ int StateRegistry::get_state_size_in_bytes() const {
 
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
-    registered_states.print_statistics(log);
+    if (concurrent_states) {
+        log << "Number of lock stripes: "
+            << concurrent_states->get_num_stripes() << endl;
+    } else if (compressed_states) {
+        size_t num_nodes = size() + compressed_states->get_num_inner_nodes();
+        log << "Number of compressed state nodes: " << num_nodes << endl;
+        if (size() != 0) {
+            log << "Compressed bytes per state: "
+                << static_cast<double>(num_nodes * 2 * sizeof(PackedStateBin)) / size()
+                << endl;
+        }
+    } else {
+        if (state_data_arena) {
+            log << "State data mapped from disk: "
+                << state_data_arena->get_mapped_bytes() / 1024 << " KB" << endl;
+        }
+        registered_states.print_statistics(log);
+    }
 }
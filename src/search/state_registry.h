@@ -10,6 +10,7 @@
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
+#include "utils/mapped_file_arena.h"
 
 #include <set>
 
@@ -59,6 +60,37 @@
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
 
+  Thread-safe StateRegistry
+    A StateRegistry created with thread_safe = true can register and look up
+    states from several threads concurrently. It stores the state data in a
+    ConcurrentSegmentedArrayVector and distributes the hash set of StateIDs
+    over several lock stripes selected by the state hash, so that threads only
+    contend when they register states in the same stripe. IDs are still
+    dense. Each thread must learn about the states registered by other threads
+    through proper synchronization (e.g., a mutex-protected open list). Note
+    that PerStateInformation is not thread-safe.
+
+  Compressed StateRegistry
+    After enable_state_compression(), the registry stores states in a tree
+    compression scheme instead of the SegmentedArrayVector of packed states.
+    The packed bins of a state are the leaves of a balanced binary tree. Each
+    inner node is stored as a pair of references to its children (bin values
+    for leaves, indices into a shared node dictionary otherwise), and equal
+    nodes are only stored once. A state thus costs one root pair plus the
+    inner nodes that no earlier state contains, which for states that differ
+    in few bins from their predecessors is typically much less than the
+    packed state. The ID of a state is the index of its root pair.
+    Looking up a state rebuilds its packed data in a small cache of recently
+    used states. The resulting State objects own their packed data, so the
+    data stays valid as long as the State exists.
+
+  Disk-backed StateRegistry
+    After store_states_on_disk(), the segments of the state data pool are
+    allocated from a MappedFileArena, i.e., from memory-mapped temporary
+    files. Only the most recently allocated part of the pool is kept in RAM
+    (up to a given budget), older parts are paged in from disk on access.
+    The hash set of StateIDs and PerStateInformation stay in RAM.
+
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
     Can be thought of as a very compactly implemented map from State to T.
@@ -113,31 +145,29 @@ using PackedStateBin = int_packer::IntPacker::Bin;
 
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    using StateDataPool = segmented_vector::SegmentedArrayVector<
+        PackedStateBin, utils::MappedFileAllocator<PackedStateBin>>;
+
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
         }
 
         int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
-            }
-            return hash_state.get_hash32();
+            return get_packed_state_hash(state_data_pool[id], state_size);
         }
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
@@ -162,15 +192,32 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    StateDataPool state_data_pool;
     StateIDSet registered_states;
+    // Only used by disk-backed registries (see above).
+    std::shared_ptr<utils::MappedFileArena> state_data_arena;
 
     std::unique_ptr<State> cached_initial_state;
 
+    // Only used by thread-safe registries (see above).
+    class ConcurrentStateSet;
+    std::unique_ptr<ConcurrentStateSet> concurrent_states;
+
+    // Only used by compressed registries (see above).
+    class CompressedStateSet;
+    std::unique_ptr<CompressedStateSet> compressed_states;
+
     StateID insert_id_or_pop_state();
+    StateID insert_state_from_buffer(const PackedStateBin *buffer);
+    const PackedStateBin *get_state_data(StateID id) const;
+    size_t get_num_concurrent_states() const;
+    size_t get_num_compressed_states() const;
+    State get_successor_state_from_buffer(
+        const State &predecessor, const OperatorProxy &op);
     int get_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    explicit StateRegistry(const TaskProxy &task_proxy, bool thread_safe = false);
+    virtual ~StateRegistry() override;
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -184,6 +231,23 @@ public:
         return state_packer;
     }
 
+    /*
+      Stores states in compressed form from now on (see above). Must be called
+      before the first state is registered and cannot be combined with
+      thread-safe or disk-backed registries. States with at most two bins are
+      not compressed because the compressed form would not be smaller.
+      Returns whether the registry compresses states.
+    */
+    bool enable_state_compression();
+
+    /*
+      Stores the state data in memory-mapped files in the given directory,
+      keeping at most ram_budget_in_mb MB of it in RAM (see above). Must be
+      called before the first state is registered and cannot be combined
+      with thread-safe or compressed registries.
+    */
+    void store_states_on_disk(const std::string &directory, int ram_budget_in_mb);
+
     /*
       Returns the state that was registered at the given ID. The ID must refer
       to a state in this registry. Do not mix IDs from from different registries.
@@ -197,9 +261,25 @@ public:
     */
     State lookup_state(StateID id, std::vector<int> &&state_values) const;
 
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The data must be packed with the state packer of
+      this registry and must not belong to this registry.
+    */
+    State register_state(const PackedStateBin *buffer);
+
+    /*
+      Returns the ID of the state with the given packed data, or
+      StateID::no_state if it is not registered. The data must not belong
+      to this registry.
+    */
+    StateID find_state_id(const PackedStateBin *buffer);
+
     /*
       Returns a reference to the initial state and registers it if this was not
       done before. The result is cached internally so subsequent calls are cheap.
+      For thread-safe registries, the first call must not run concurrently with
+      other calls of this method.
     */
     const State &get_initial_state();
 
@@ -214,11 +294,30 @@ public:
       Returns the number of states registered so far.
     */
     size_t size() const {
+        if (concurrent_states) {
+            return get_num_concurrent_states();
+        } else if (compressed_states) {
+            return get_num_compressed_states();
+        }
         return registered_states.size();
     }
 
+    bool is_thread_safe() const {
+        return concurrent_states != nullptr;
+    }
+
     int get_state_size_in_bytes() const;
 
+    // Semantic hash of packed state data (as used for duplicate detection).
+    static int_hash_set::HashType get_packed_state_hash(
+        const PackedStateBin *buffer, int num_bins) {
+        utils::HashState hash_state;
+        for (int i = 0; i < num_bins; ++i) {
+            hash_state.feed(buffer[i]);
+        }
+        return hash_state.get_hash32();
+    }
+
     void print_statistics(utils::LogProxy &log) const;
 
     class const_iterator {
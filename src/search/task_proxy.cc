@@ -28,6 +28,19 @@ State::State(const AbstractTask &task, const StateRegistry &registry,
     this->values = make_shared<vector<int>>(move(values));
 }
 
+State::State(const AbstractTask &task, const StateRegistry &registry,
+             StateID id, shared_ptr<const vector<PackedStateBin>> &&buffer)
+    : State(task, registry, id, buffer->data()) {
+    owned_buffer = move(buffer);
+}
+
+State::State(const AbstractTask &task, const StateRegistry &registry,
+             StateID id, shared_ptr<const vector<PackedStateBin>> &&buffer,
+             vector<int> &&values)
+    : State(task, registry, id, buffer->data(), move(values)) {
+    owned_buffer = move(buffer);
+}
+
 State::State(const AbstractTask &task, vector<int> &&values)
     : task(&task), registry(nullptr), id(StateID::no_state), buffer(nullptr),
       values(make_shared<vector<int>>(move(values))),
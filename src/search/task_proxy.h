@@ -579,6 +579,11 @@ class State {
       semantics of the state".
     */
     mutable std::shared_ptr<std::vector<int>> values;
+    /*
+      Owns the packed data if the registry does not keep it in uncompressed
+      form (see StateRegistry). Otherwise, buffer points into the registry.
+    */
+    std::shared_ptr<const std::vector<PackedStateBin>> owned_buffer;
     const int_packer::IntPacker *state_packer;
     int num_variables;
 public:
@@ -590,6 +595,12 @@ public:
     // Construct a registered state with packed and unpacked data.
     State(const AbstractTask &task, const StateRegistry &registry, StateID id,
           const PackedStateBin *buffer, std::vector<int> &&values);
+    // Construct registered states whose packed data is owned by the state.
+    State(const AbstractTask &task, const StateRegistry &registry, StateID id,
+          std::shared_ptr<const std::vector<PackedStateBin>> &&buffer);
+    State(const AbstractTask &task, const StateRegistry &registry, StateID id,
+          std::shared_ptr<const std::vector<PackedStateBin>> &&buffer,
+          std::vector<int> &&values);
     // Construct a state with only unpacked data.
     State(const AbstractTask &task, std::vector<int> &&values);
 
@@ -699,6 +710,22 @@ public:
         return State(*task, registry, id, buffer, std::move(state_values));
     }
 
+    // This method is meant to be called only by the state registry.
+    State create_state(
+        const StateRegistry &registry, StateID id,
+        std::shared_ptr<const std::vector<PackedStateBin>> &&buffer) const {
+        return State(*task, registry, id, std::move(buffer));
+    }
+
+    // This method is meant to be called only by the state registry.
+    State create_state(
+        const StateRegistry &registry, StateID id,
+        std::shared_ptr<const std::vector<PackedStateBin>> &&buffer,
+        std::vector<int> &&state_values) const {
+        return State(*task, registry, id, std::move(buffer),
+                     std::move(state_values));
+    }
+
     State get_initial_state() const {
         return create_state(task->get_initial_state_values());
     }
@@ -784,16 +811,9 @@ inline void State::unpack() const {
           in the required size and then assigning values was faster than the
           more obvious reserve/push_back. Although, the benchmark did not
           profile this specific code.
-
-          We might consider a bulk-unpack method in state_packer that could be
-          more efficient. (One can imagine state packer to have extra data
-          structures that exploit sequentially unpacking each entry, by doing
-          things bin by bin.)
         */
         values = std::make_shared<std::vector<int>>(num_variables);
-        for (int var = 0; var < num_variables; ++var) {
-            (*values)[var] = state_packer->get(buffer, var);
-        }
+        state_packer->unpack_all(buffer, values->data());
     }
 }
 
@@ -167,6 +167,8 @@ void dump_task(const TaskProxy &task_proxy) {
     dump_goals(task_proxy.get_goals());
 }
 
+bool g_use_byte_aligned_state_packing = false;
+
 PerTaskInformation<int_packer::IntPacker> g_state_packers(
     [](const TaskProxy &task_proxy) {
         VariablesProxy variables = task_proxy.get_variables();
@@ -175,7 +177,8 @@ PerTaskInformation<int_packer::IntPacker> g_state_packers(
         for (VariableProxy var : variables) {
             variable_ranges.push_back(var.get_domain_size());
         }
-        return utils::make_unique_ptr<int_packer::IntPacker>(variable_ranges);
+        return utils::make_unique_ptr<int_packer::IntPacker>(
+            variable_ranges, g_use_byte_aligned_state_packing);
     }
     );
 }
@@ -82,6 +82,12 @@ extern void dump_fdr(const State &state);
 extern void dump_goals(const GoalsProxy &goals);
 extern void dump_task(const TaskProxy &task_proxy);
 
+/*
+  If set, g_state_packers pack the state variables byte-aligned, which
+  trades memory for faster packing and unpacking (see IntPacker). Must be
+  set before the first state packer is created.
+*/
+extern bool g_use_byte_aligned_state_packing;
 extern PerTaskInformation<int_packer::IntPacker> g_state_packers;
 }
 
@@ -1,213 +1,285 @@
 #include "pi_m_compiled_task.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 
+#include <algorithm>
+#include <cassert>
 
 using namespace std;
 namespace extra_tasks {
 
-PiMCompiledTask::PiMCompiledTask(const shared_ptr<AbstractTask> &parent) : DelegatingTask(parent) {
-    init_meta_atom_map();
+PiMCompiledTask::PiMCompiledTask(const shared_ptr<AbstractTask> &parent, int num_threads)
+    : DelegatingTask(parent),
+      num_threads(num_threads) {
+    init_fact_indices();
     setup_init_and_goal_states();
-	setup_meta_operators();
-
+    setup_meta_operators();
 }
+
 /*
- * Initialize meta_atom_map that serves as dictionary between SAS+ and STRIPS representation.
+ * Assign global indices to the atoms of the parent task. Together with get_meta_atom, they serve as dictionary between
+ * SAS+ and STRIPS representation.
  */
-void PiMCompiledTask::init_meta_atom_map() {
-	meta_atom_map = {{pair(FactPair(-1, -1), FactPair(-1, -1)), 0}};
-    int num_var = parent->get_num_variables();
-    int index = 1;
-    for (int var = 0; var < num_var; ++var) {
+void PiMCompiledTask::init_fact_indices() {
+    num_facts = 0;
+    for (int var = 0; var < parent->get_num_variables(); ++var) {
+        fact_offsets.push_back(num_facts);
         for (int val = 0; val < parent->get_variable_domain_size(var); ++val) {
-            for (int value = val; value < parent->get_variable_domain_size(var); ++value) {
-                meta_atom_map[pair(FactPair(var, val), FactPair(var, value))] = index;
-            	index++;
-        	}
-            for (int variable = var + 1; variable < num_var; ++variable) {
-        		for (int value = 0; value < parent->get_variable_domain_size(variable); ++value) {
-                    meta_atom_map[pair(FactPair(var, val), FactPair(variable, value))] = index;
-            		index++;
-        		}
-    		}
+            index_to_fact.emplace_back(var, val);
         }
+        num_facts += parent->get_variable_domain_size(var);
     }
 }
 
 /*
- * Setup initial_state_values and goals. goal_atoms for constant time check if atom part of goal.
+ * Returns the meta atom of {a, b}. The pairs are ranked row by row, i.e., {a, b} with a <= b comes after all pairs
+ * with a smaller first atom, which occupy sum_{i < a} (num_facts - i) meta atoms after the empty set.
  */
-void PiMCompiledTask::setup_init_and_goal_states() {
-    initial_state_values.assign(meta_atom_map.size(), 0);
-    vector<int> init_state_values = parent->get_initial_state_values();
-    unordered_set<FactPair, FactPairHash> goal_atoms;
-    for (int i = 0; i < parent->get_num_goals(); ++i) {
-        goal_atoms.insert(parent->get_goal_fact(i));
+int PiMCompiledTask::get_meta_atom(int a, int b) const {
+    if (a > b) {
+        swap(a, b);
     }
+    const long long a_ = a;
+    return static_cast<int>(1 + a_ * num_facts - a_ * (a_ - 1) / 2 + (b - a));
+}
 
-	for (const auto& [current_atoms, i] : meta_atom_map) {
-        if (current_atoms.first.var == -1 || init_state_values[current_atoms.first.var] == current_atoms.first.value) {
-        	if (current_atoms.second.var == -1 || init_state_values[current_atoms.second.var] == current_atoms.second.value) {
-        		initial_state_values[i] = 1;
-        	}
-        }
-        if (current_atoms.first.var == -1 || goal_atoms.find(current_atoms.first) != goal_atoms.end()) {
-        	if (current_atoms.second.var == -1 || goal_atoms.find(current_atoms.second) != goal_atoms.end()) {
-            	goals.push_back(FactPair(i, 1));
-        	}
-        }
-    }
+int PiMCompiledTask::get_parent_operator(int op_index) const {
+    auto it = upper_bound(meta_operator_offsets.begin(), meta_operator_offsets.end(), op_index);
+    return static_cast<int>(it - meta_operator_offsets.begin()) - 1;
 }
 
 /*
- * Add meta operators to meta_operators list by first building meta-operator for S = ∅. Afterwards, extend new_pre and new_eff with specific atom in S.
+ * Setup initial_state_values and goals. A meta atom holds (is a goal) iff both of its atoms hold (are goals).
  */
-void PiMCompiledTask::setup_meta_operators() {
-    meta_operators = {};
-    for (int op_id = 0; op_id < parent->get_num_operators(); ++op_id) {
-        // To check S ∩ (add(o) ∪ del(o)) = ∅
-		unordered_set<int> effect_vars;
-        vector<FactPair> new_pre = generate_meta_preconditions(op_id);
-        vector<FactPair> new_eff = generate_meta_effects(op_id, effect_vars);
-
-        // S = ∅
-        meta_operators.push_back(MetaOperator(op_id, FactPair(-1, -1), new_pre, new_eff, parent->get_operator_cost(op_id, false)));
+void PiMCompiledTask::setup_init_and_goal_states() {
+    vector<bool> is_init_atom(num_facts, false);
+    vector<int> init_state_values = parent->get_initial_state_values();
+    for (size_t var = 0; var < init_state_values.size(); ++var) {
+        is_init_atom[get_fact_index(FactPair(var, init_state_values[var]))] = true;
+    }
+    vector<bool> is_goal_atom(num_facts, false);
+    for (int i = 0; i < parent->get_num_goals(); ++i) {
+        is_goal_atom[get_fact_index(parent->get_goal_fact(i))] = true;
+    }
 
-        for (int var = 0; var < parent->get_num_variables(); ++var) {
-            if (effect_vars.find(var) != effect_vars.end()) {
-            	continue;
-            }
-            for (int val = 0; val < parent->get_variable_domain_size(var); val++) {
-            	FactPair s_atom = FactPair(var, val);
-                if (contradict_precondition(op_id, s_atom)) {
-                	continue;
+    initial_state_values.assign(get_meta_atom(num_facts - 1, num_facts - 1) + 1, 0);
+    initial_state_values[0] = 1;
+    goals.emplace_back(0, 1);
+    // Every chunk of atoms a writes the disjoint rows {a, b} of initial_state_values.
+    vector<vector<FactPair>> chunk_goals(utils::get_num_threads(num_threads));
+    int num_chunks = utils::run_in_chunks(
+        num_facts, num_threads, [&](int chunk, int begin, int end) {
+            for (int a = begin; a < end; ++a) {
+                for (int b = a; b < num_facts; ++b) {
+                    if (is_init_atom[a] && is_init_atom[b]) {
+                        initial_state_values[get_meta_atom(a, b)] = 1;
+                    }
+                    if (is_goal_atom[a] && is_goal_atom[b]) {
+                        chunk_goals[chunk].emplace_back(get_meta_atom(a, b), 1);
+                    }
                 }
-            	vector<FactPair> copy_pre(new_pre);
-            	copy_pre.push_back(FactPair(meta_atom_map[pair(s_atom, s_atom)], 1));
-            	for (int i = 0; i < parent->get_num_operator_preconditions(op_id, false); ++i) {
-					FactPair pre = parent->get_operator_precondition(op_id, i, false);
-                	FactPair meta_pre = translate_into_meta_atom(pre, s_atom);
-                	if (meta_pre.var != -2) {
-                    	copy_pre.push_back(meta_pre);
-                	}
-            	}
-            	vector<FactPair> copy_eff(new_eff);
-            	for (int i = 0; i < parent->get_num_operator_effects(op_id, false); ++i) {
-					FactPair eff = parent->get_operator_effect(op_id, i, false);
-                	FactPair meta_eff = translate_into_meta_atom(eff, s_atom);
-                	if (meta_eff.var != -2) {
-                    	copy_eff.push_back(meta_eff);
-                	}
-            	}
-				meta_operators.push_back(MetaOperator(op_id, s_atom, copy_pre, copy_eff, parent->get_operator_cost(op_id, false)));
             }
-        }
+        });
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+        goals.insert(goals.end(), chunk_goals[chunk].begin(), chunk_goals[chunk].end());
     }
 }
 
 /*
- * Translates SAS+ atoms into STRIPS variables by using meta_atom_map.
+ * Set up the meta operators. For every parent operator, only the meta atoms of S = ∅ and the valid S-atoms are stored.
+ * Chunks of parent operators are processed in parallel twice: first to set up the operator data and count the
+ * meta operators, then to write the S-atoms to their final positions in s_atoms.
  */
-FactPair PiMCompiledTask::translate_into_meta_atom(FactPair first_atom, FactPair second_atom) {
-    pair atom_pair = pair(FactPair(-1, -1), FactPair(-1, -1));
-	if (first_atom < second_atom) {
-        atom_pair = pair(first_atom, second_atom);
-    } else {
-    	atom_pair = pair(second_atom, first_atom);
-    }
-    if (meta_atom_map.find(atom_pair) == meta_atom_map.end()) {
-        return FactPair(-2, -2);
+void PiMCompiledTask::setup_meta_operators() {
+    const int num_operators = parent->get_num_operators();
+    parent_preconditions.resize(num_operators);
+    parent_effects.resize(num_operators);
+    base_preconditions.resize(num_operators);
+    base_effects.resize(num_operators);
+    vector<int> num_meta_operators(num_operators);
+    utils::run_in_chunks(
+        num_operators, num_threads, [&](int, int begin, int end) {
+            setup_parent_operators(begin, end, num_meta_operators);
+        });
+
+    meta_operator_offsets.reserve(num_operators + 1);
+    int offset = 0;
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        meta_operator_offsets.push_back(offset);
+        offset += num_meta_operators[op_id];
     }
+    meta_operator_offsets.push_back(offset);
 
-    return FactPair(meta_atom_map[atom_pair], 1);
+    s_atoms.resize(offset);
+    utils::run_in_chunks(
+        num_operators, num_threads, [&](int, int begin, int end) {
+            setup_s_atoms(begin, end);
+        });
 }
 
-bool PiMCompiledTask::contradict_precondition(int op_id, FactPair s_atom) {
-	for (int i = 0; i < parent->get_num_operator_preconditions(op_id, false); ++i) {
-		FactPair pre = parent->get_operator_precondition(op_id, i, false);
-    	if (pre.var == s_atom.var && pre.value != s_atom.value) {
-        	return true;
-    	}
+/*
+ * Set up the data of the parent operators [begin, end) and count their meta operators.
+ */
+void PiMCompiledTask::setup_parent_operators(int begin, int end, vector<int> &num_meta_operators) {
+    vector<bool> is_effect_var(parent->get_num_variables(), false);
+    for (int op_id = begin; op_id < end; ++op_id) {
+        vector<int> pre;
+        for (int i = 0; i < parent->get_num_operator_preconditions(op_id, false); ++i) {
+            pre.push_back(get_fact_index(parent->get_operator_precondition(op_id, i, false)));
+        }
+        vector<int> eff;
+        // S = ∅
+        int num_s_atoms = 1 + num_facts;
+        for (int i = 0; i < parent->get_num_operator_effects(op_id, false); ++i) {
+            FactPair fact = parent->get_operator_effect(op_id, i, false);
+            eff.push_back(get_fact_index(fact));
+            if (!is_effect_var[fact.var]) {
+                // S ∩ (add(o) ∪ del(o)) = ∅ excludes all atoms of fact.var.
+                is_effect_var[fact.var] = true;
+                num_s_atoms -= parent->get_variable_domain_size(fact.var);
+            }
+        }
+        for (int fact : pre) {
+            int var = index_to_fact[fact].var;
+            if (!is_effect_var[var]) {
+                // All other atoms of var contradict pre(o).
+                num_s_atoms -= parent->get_variable_domain_size(var) - 1;
+            }
+        }
+        num_meta_operators[op_id] = num_s_atoms;
+
+        vector<int> base_pre = generate_meta_atoms(pre);
+        base_pre.insert(base_pre.begin(), 0);
+        base_preconditions[op_id] = move(base_pre);
+        base_effects[op_id] = generate_meta_atoms(eff);
+        parent_preconditions[op_id] = move(pre);
+        parent_effects[op_id] = move(eff);
+
+        for (int fact : parent_effects[op_id]) {
+            is_effect_var[index_to_fact[fact].var] = false;
+        }
     }
-    return false;
 }
 
 /*
- * Generate meta_preconditions for op for S = ∅.
+ * Write the S-atoms of the meta operators of the parent operators [begin, end).
  */
-vector<FactPair> PiMCompiledTask::generate_meta_preconditions(int op_id) {
-    vector<FactPair> new_pre = {FactPair(meta_atom_map[{FactPair(-1, -1), FactPair(-1, -1)}], 1)};
-    for (int i = 0; i < parent->get_num_operator_preconditions(op_id, false); ++i) {
-		FactPair pre = parent->get_operator_precondition(op_id, i, false);
-        for (int j = 0; j < parent->get_num_operator_preconditions(op_id, false); ++j) {
-			FactPair second_pre = parent->get_operator_precondition(op_id, j, false);
-            FactPair meta_pre = translate_into_meta_atom(pre, second_pre);
-            if (meta_pre.var != -2) {
-                new_pre.push_back(meta_pre);
+void PiMCompiledTask::setup_s_atoms(int begin, int end) {
+    vector<bool> is_effect_var(parent->get_num_variables(), false);
+    for (int op_id = begin; op_id < end; ++op_id) {
+        for (int fact : parent_effects[op_id]) {
+            is_effect_var[index_to_fact[fact].var] = true;
+        }
+        int index = meta_operator_offsets[op_id];
+        // S = ∅
+        s_atoms[index++] = -1;
+        for (int s_atom = 0; s_atom < num_facts; ++s_atom) {
+            if (!is_effect_var[index_to_fact[s_atom].var] && !contradict_precondition(op_id, s_atom)) {
+                s_atoms[index++] = s_atom;
             }
         }
+        assert(index == meta_operator_offsets[op_id + 1]);
+        for (int fact : parent_effects[op_id]) {
+            is_effect_var[index_to_fact[fact].var] = false;
+        }
+    }
+}
+
+bool PiMCompiledTask::contradict_precondition(int op_id, int s_atom) const {
+    const FactPair &s = index_to_fact[s_atom];
+    for (int pre : parent_preconditions[op_id]) {
+        const FactPair &fact = index_to_fact[pre];
+        if (fact.var == s.var && fact.value != s.value) {
+            return true;
+        }
     }
-    return new_pre;
+    return false;
 }
 
 /*
- * Generate meta_effects for op for S = ∅.
+ * Generate the meta atoms of all subsets of size one and two of facts.
  */
-vector<FactPair> PiMCompiledTask::generate_meta_effects(int op_id, unordered_set<int> &effect_vars) {
-    vector<FactPair> new_eff;
-    for (int i = 0; i < parent->get_num_operator_effects(op_id, false); ++i) {
-		FactPair eff = parent->get_operator_effect(op_id, i, false);
-        effect_vars.insert(eff.var);
-        for (int j = 0; j < parent->get_num_operator_effects(op_id, false); ++j) {
-			FactPair second_eff = parent->get_operator_effect(op_id, j, false);
-            FactPair meta_eff = translate_into_meta_atom(eff, second_eff);
-            if (meta_eff.var != -2) {
-                new_eff.push_back(meta_eff);
-            }
+vector<int> PiMCompiledTask::generate_meta_atoms(const vector<int> &facts) const {
+    vector<int> meta_atoms;
+    for (size_t i = 0; i < facts.size(); ++i) {
+        for (size_t j = i; j < facts.size(); ++j) {
+            meta_atoms.push_back(get_meta_atom(facts[i], facts[j]));
         }
     }
-    return new_eff;
+    utils::sort_unique(meta_atoms);
+    return meta_atoms;
 }
 
 int PiMCompiledTask::get_num_variables() const {
-    return meta_atom_map.size();
+    return initial_state_values.size();
 }
 
 int PiMCompiledTask::get_variable_domain_size(int var) const {
-	(void)var;
+    (void)var;
     return 2;
 }
 
 int PiMCompiledTask::get_operator_cost(int index, bool is_axiom) const {
     (void)is_axiom;
-    return meta_operators[index].cost;
+    return parent->get_operator_cost(get_parent_operator(index), false);
 }
 
 
 int PiMCompiledTask::get_num_operators() const {
-    return meta_operators.size();
+    return s_atoms.size();
 }
 
 int PiMCompiledTask::get_num_operator_preconditions(int index, bool is_axiom) const {
     (void)is_axiom;
-    return meta_operators[index].preconditions.size();
+    int parent_id = get_parent_operator(index);
+    int num_preconditions = base_preconditions[parent_id].size();
+    if (s_atoms[index] != -1) {
+        // {s} and {p, s} for every p in pre(o).
+        num_preconditions += 1 + parent_preconditions[parent_id].size();
+    }
+    return num_preconditions;
 }
 
 FactPair PiMCompiledTask::get_operator_precondition(int op_index, int fact_index, bool is_axiom) const {
     (void)is_axiom;
-    return meta_operators[op_index].preconditions[fact_index];
+    int parent_id = get_parent_operator(op_index);
+    const vector<int> &base_pre = base_preconditions[parent_id];
+    if (fact_index < static_cast<int>(base_pre.size())) {
+        return FactPair(base_pre[fact_index], 1);
+    }
+    int s_atom = s_atoms[op_index];
+    assert(s_atom != -1);
+    fact_index -= base_pre.size();
+    if (fact_index == 0) {
+        return FactPair(get_meta_atom(s_atom, s_atom), 1);
+    }
+    return FactPair(get_meta_atom(parent_preconditions[parent_id][fact_index - 1], s_atom), 1);
 }
 
 int PiMCompiledTask::get_num_operator_effects(int op_index, bool is_axiom) const {
     (void)is_axiom;
-	return meta_operators[op_index].effects.size();
+    int parent_id = get_parent_operator(op_index);
+    int num_effects = base_effects[parent_id].size();
+    if (s_atoms[op_index] != -1) {
+        // {e, s} for every e in eff(o).
+        num_effects += parent_effects[parent_id].size();
+    }
+    return num_effects;
 }
 
 FactPair PiMCompiledTask::get_operator_effect(int op_index, int eff_index, bool is_axiom) const {
     (void)is_axiom;
-    return meta_operators[op_index].effects[eff_index];
+    int parent_id = get_parent_operator(op_index);
+    const vector<int> &base_eff = base_effects[parent_id];
+    if (eff_index < static_cast<int>(base_eff.size())) {
+        return FactPair(base_eff[eff_index], 1);
+    }
+    assert(s_atoms[op_index] != -1);
+    int eff = parent_effects[parent_id][eff_index - base_eff.size()];
+    return FactPair(get_meta_atom(eff, s_atoms[op_index]), 1);
 }
 
 FactPair PiMCompiledTask::get_goal_fact(int index) const {
@@ -223,29 +295,26 @@ vector<int> PiMCompiledTask::get_initial_state_values() const {
 }
 
 int PiMCompiledTask::get_num_operator_effect_conditions(
-        int op_index, int eff_index, bool is_axiom) const {
+    int op_index, int eff_index, bool is_axiom) const {
     (void) op_index; (void) eff_index; (void)is_axiom;
-	return 0;
+    return 0;
 }
 
-
-
 void PiMCompiledTask::convert_state_values_from_parent(std::vector<int> &values) const {
     std::vector<int> new_values(initial_state_values.size(), 0);
-	new_values[0] = 1;
-	for (size_t i = 0; i < values.size(); ++i) {
-		FactPair atom = FactPair(i, values[i]);
-		new_values[meta_atom_map.at(pair(atom, atom))] = 1;
-		for (size_t j = i + 1; j < values.size(); ++j) {
-			FactPair second_atom = FactPair(j, values[j]);
-			new_values[meta_atom_map.at(pair(atom, second_atom))] = 1;
-		}
-	}
-	values = std::move(new_values);
+    new_values[0] = 1;
+    for (size_t i = 0; i < values.size(); ++i) {
+        int atom = get_fact_index(FactPair(i, values[i]));
+        new_values[get_meta_atom(atom, atom)] = 1;
+        for (size_t j = i + 1; j < values.size(); ++j) {
+            new_values[get_meta_atom(atom, get_fact_index(FactPair(j, values[j])))] = 1;
+        }
+    }
+    values = std::move(new_values);
 }
 
 std::shared_ptr<AbstractTask> build_pi_m_compiled_task(
-	const shared_ptr<AbstractTask> &parent) {
-	return make_shared<PiMCompiledTask>(parent);
+    const shared_ptr<AbstractTask> &parent, int num_threads) {
+    return make_shared<PiMCompiledTask>(parent, num_threads);
+}
 }
-}
\ No newline at end of file
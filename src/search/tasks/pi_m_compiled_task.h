@@ -6,58 +6,66 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 
 class AbstractTask;
 
 namespace extra_tasks {
+/*
+  Pi^m compilation for m = 2. Every set of at most two atoms of the parent
+  task is a binary meta atom. Meta atom 0 is the empty set, the set {a, b}
+  of global fact indices a <= b is ranked arithmetically (see
+  get_meta_atom), so no map between atom pairs and meta atoms is stored.
+
+  A meta operator consists of a parent operator and an atom s of the parent
+  task (S = {s}, or S = ∅ for s = -1). Meta operators with the same parent
+  share their S = ∅ preconditions and effects, the additional pairs {p, s}
+  and {e, s} of an S-atom are computed when they are requested.
+
+  The meta operators (and the initial state and goal meta atoms) are set up
+  by num_threads threads in contiguous chunks of parent operators (atoms).
+  Every chunk writes to fixed positions or its results are merged in chunk
+  order, so the compiled task is identical for every number of threads.
+*/
 class PiMCompiledTask : public tasks::DelegatingTask {
-
-    struct FactPairHash {
-        size_t operator()(const FactPair &fact) const {
-            return fact.var * 100003 + fact.value;
-        }
-    };
-	struct AtomPairHash {
-		std::size_t operator()(std::pair<FactPair, FactPair> pair) const {
-            const int MOD = 100003;
-            std::size_t h1 = pair.first.var * MOD + pair.first.value;
-            std::size_t h2 = pair.second.var * MOD + pair.second.value;
-            return h1 * MOD + h2;
-        }
-	};
-
-    std::unordered_map<std::pair<FactPair,FactPair>, int, AtomPairHash> meta_atom_map;
-	std::vector<int> initial_state_values;
-	std::vector<FactPair> goals;
-
-
-    struct MetaOperator {
-    int parent_id;
-    FactPair s_atom;
-    std::vector<FactPair> preconditions;
-    std::vector<FactPair> effects;
-    int cost;
-
-    MetaOperator(const int par_id, const FactPair s,
-                 const std::vector<FactPair> pre, const std::vector<FactPair> eff, const int c) :
-				parent_id(par_id), s_atom(s), preconditions(pre), effects(eff), cost(c) {}
-	};
-
-    std::vector<MetaOperator> meta_operators;
-public:
-	PiMCompiledTask(const std::shared_ptr<AbstractTask> &parent);
-    // Main functions to set up compiled task
-    void init_meta_atom_map();
+    const int num_threads;
+    int num_facts;
+    // Global index of fact (var, 0) for every variable.
+    std::vector<int> fact_offsets;
+    std::vector<FactPair> index_to_fact;
+
+    std::vector<int> initial_state_values;
+    std::vector<FactPair> goals;
+
+    // Pre and eff of the parent operators as global fact indices.
+    std::vector<std::vector<int>> parent_preconditions;
+    std::vector<std::vector<int>> parent_effects;
+    // Meta atoms of pre and eff of the parent operators for S = ∅.
+    std::vector<std::vector<int>> base_preconditions;
+    std::vector<std::vector<int>> base_effects;
+    /*
+      The meta operators of parent operator op are numbered from
+      meta_operator_offsets[op] to meta_operator_offsets[op + 1] - 1, the
+      first of them has S = ∅. s_atoms stores S for every meta operator.
+    */
+    std::vector<int> meta_operator_offsets;
+    std::vector<int> s_atoms;
+
+    int get_fact_index(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    int get_meta_atom(int a, int b) const;
+    int get_parent_operator(int op_index) const;
+
+    void init_fact_indices();
     void setup_init_and_goal_states();
     void setup_meta_operators();
-
-    // Helper functions
-    FactPair translate_into_meta_atom(FactPair first_atom, FactPair second_atom);
-    bool contradict_precondition(int op_id, FactPair s_atom);
-    std::vector<FactPair> generate_meta_preconditions(int op_id);
-    std::vector<FactPair> generate_meta_effects(int op_id, std::unordered_set<int> &effect_vars);
+    void setup_parent_operators(int begin, int end, std::vector<int> &num_meta_operators);
+    void setup_s_atoms(int begin, int end);
+    bool contradict_precondition(int op_id, int s_atom) const;
+    std::vector<int> generate_meta_atoms(const std::vector<int> &facts) const;
+public:
+    PiMCompiledTask(const std::shared_ptr<AbstractTask> &parent, int num_threads = 1);
 
     // Functions to access compiled task transformation
     virtual int get_num_variables() const override;
@@ -65,7 +73,7 @@ public:
     virtual int get_operator_cost(int index, bool is_axiom) const override;
     virtual int get_num_operators() const override;
     virtual int get_num_operator_preconditions(int index, bool is_axiom) const override;
-	virtual FactPair get_operator_precondition(
+    virtual FactPair get_operator_precondition(
         int op_index, int fact_index, bool is_axiom) const override;
     virtual int get_num_operator_effects(int op_index, bool is_axiom) const override;
     virtual FactPair get_operator_effect(
@@ -77,13 +85,11 @@ public:
         int op_index, int eff_index, bool is_axiom) const override;
     virtual void convert_state_values_from_parent(
         std::vector<int> &values) const override;
-
 };
 
 
 std::shared_ptr<AbstractTask> build_pi_m_compiled_task(
-	const std::shared_ptr<AbstractTask> &parent);
-
+    const std::shared_ptr<AbstractTask> &parent, int num_threads = 1);
 }
 
 #endif //PI_M_COMPILED_TASK_H
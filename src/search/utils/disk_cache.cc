@@ -0,0 +1,120 @@
+#include "disk_cache.h"
+
+#include "language.h"
+#include "system.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+string g_cache_directory;
+
+void set_cache_directory(const string &directory) {
+#if OPERATING_SYSTEM == WINDOWS
+    utils::unused_variable(directory);
+    cerr << "Caching results on disk is not supported on Windows." << endl;
+    exit_with(ExitCode::SEARCH_UNSUPPORTED);
+#else
+    error_code error;
+    filesystem::create_directories(directory, error);
+    if (error) {
+        cerr << "Could not create cache directory " << directory << ": "
+             << error.message() << endl;
+        exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    g_cache_directory = directory;
+#endif
+}
+
+MappedFile::MappedFile(const char *data, size_t size)
+    : data(data),
+      size(size) {
+}
+
+MappedFile::~MappedFile() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (size > 0) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+}
+
+unique_ptr<MappedFile> MappedFile::open(const string &path) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat file_status;
+    if (fstat(fd, &file_status) == -1) {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = file_status.st_size;
+    if (size == 0) {
+        close(fd);
+        return unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the file.
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return unique_ptr<MappedFile>(
+        new MappedFile(static_cast<const char *>(data), size));
+#else
+    utils::unused_variable(path);
+    return nullptr;
+#endif
+}
+
+unique_ptr<MappedFile> open_cache_file(const string &name) {
+    if (g_cache_directory.empty()) {
+        return nullptr;
+    }
+    return MappedFile::open(
+        (filesystem::path(g_cache_directory) / name).string());
+}
+
+void write_cache_file(
+    const string &name, const function<void(ostream &)> &write) {
+    if (g_cache_directory.empty()) {
+        return;
+    }
+    // Distinguishes the temporary files of threads within this process.
+    static atomic<int> next_temporary_file(0);
+    filesystem::path path = filesystem::path(g_cache_directory) / name;
+    filesystem::path temporary_path = path;
+    temporary_path += ".tmp-" + to_string(get_process_id()) + "-" +
+        to_string(next_temporary_file++);
+    {
+        ofstream stream(temporary_path, ios::binary | ios::trunc);
+        if (stream) {
+            write(stream);
+        }
+        stream.close();
+        if (!stream) {
+            error_code error;
+            filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+    error_code error;
+    filesystem::rename(temporary_path, path, error);
+    if (error) {
+        filesystem::remove(temporary_path, error);
+    }
+}
+}
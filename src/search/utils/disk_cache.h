@@ -0,0 +1,68 @@
+#ifndef UTILS_DISK_CACHE_H
+#define UTILS_DISK_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace utils {
+/*
+  Directory in which components cache results between planner runs, set
+  with --cache-directory. Empty if caching is disabled.
+
+  Cache files are written to a temporary file first and then renamed, so
+  concurrent planner runs sharing the directory never see partial files.
+  Caching is best-effort: files that cannot be read or written are treated
+  like missing files.
+
+  Only supported on Linux and macOS.
+*/
+extern std::string g_cache_directory;
+
+// Set g_cache_directory and create the directory if necessary.
+extern void set_cache_directory(const std::string &directory);
+
+/*
+  Read-only memory mapping of a file. The pages are loaded on first access
+  and shared with all processes that map the same file.
+*/
+class MappedFile {
+    const char *data;
+    std::size_t size;
+
+    MappedFile(const char *data, std::size_t size);
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Return nullptr if the file does not exist or cannot be mapped.
+    static std::unique_ptr<MappedFile> open(const std::string &path);
+
+    const char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+
+/*
+  Map the file with the given name in the cache directory. Return nullptr
+  if caching is disabled or the file is missing.
+*/
+extern std::unique_ptr<MappedFile> open_cache_file(const std::string &name);
+
+/*
+  Create the file with the given name in the cache directory, with the
+  content produced by write. Does nothing if caching is disabled.
+*/
+extern void write_cache_file(
+    const std::string &name, const std::function<void(std::ostream &)> &write);
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "mapped_file_arena.h"
+
+#include "language.h"
+#include "system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+static const size_t ALIGNMENT = alignof(max_align_t);
+
+static size_t round_up(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+MappedFileArena::MappedFileArena(
+    const string &directory, size_t ram_budget_in_bytes)
+    : directory(directory),
+      num_resident_chunks(max<size_t>(ram_budget_in_bytes / CHUNK_BYTES, 1)),
+      used_bytes_in_last_chunk(0),
+      next_chunk_to_release(0) {
+#if OPERATING_SYSTEM == WINDOWS
+    cerr << "Memory-mapped storage is not supported on Windows." << endl;
+    exit_with(ExitCode::SEARCH_UNSUPPORTED);
+#endif
+}
+
+MappedFileArena::~MappedFileArena() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    for (const Chunk &chunk : chunks) {
+        munmap(chunk.data, chunk.size);
+    }
+#endif
+}
+
+void MappedFileArena::add_chunk(size_t size) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    string path_template = directory + "/downward-XXXXXX";
+    vector<char> path(path_template.begin(), path_template.end());
+    path.push_back('\0');
+    int fd = mkstemp(path.data());
+    if (fd == -1) {
+        cerr << "Could not create a file in " << directory << ": "
+             << strerror(errno) << endl;
+        exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // The mapping keeps the file alive until it is unmapped.
+    unlink(path.data());
+    if (ftruncate(fd, size) == -1) {
+        cerr << "Could not resize a file in " << directory << ": "
+             << strerror(errno) << endl;
+        exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        cerr << "Could not map a file in " << directory << ": "
+             << strerror(errno) << endl;
+        exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    chunks.push_back({static_cast<char *>(data), size});
+    used_bytes_in_last_chunk = 0;
+
+    if (chunks.size() > num_resident_chunks) {
+        release_chunk(chunks.size() - num_resident_chunks - 1);
+        /*
+          Dropped chunks are read back on access. Cycling through the older
+          chunks releases such pages again over time.
+        */
+        size_t num_old_chunks = chunks.size() - num_resident_chunks - 1;
+        if (num_old_chunks > 0) {
+            release_chunk(next_chunk_to_release % num_old_chunks);
+            next_chunk_to_release = next_chunk_to_release % num_old_chunks + 1;
+        }
+    }
+#else
+    utils::unused_variable(size);
+    ABORT("Memory-mapped storage is not supported on this platform.");
+#endif
+}
+
+void MappedFileArena::release_chunk(size_t index) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    const Chunk &chunk = chunks[index];
+#ifdef MADV_PAGEOUT
+    // Writes the pages back and frees them (Linux 5.4 and later).
+    if (madvise(chunk.data, chunk.size, MADV_PAGEOUT) == 0) {
+        return;
+    }
+#endif
+    /*
+      For shared file mappings, the data survives in the file (and the page
+      cache, from which the kernel can write it back and evict it).
+    */
+    msync(chunk.data, chunk.size, MS_ASYNC);
+    madvise(chunk.data, chunk.size, MADV_DONTNEED);
+#else
+    utils::unused_variable(index);
+#endif
+}
+
+void *MappedFileArena::allocate(size_t bytes) {
+    bytes = round_up(max<size_t>(bytes, 1), ALIGNMENT);
+    if (bytes > CHUNK_BYTES) {
+        add_chunk(round_up(bytes, CHUNK_BYTES));
+        used_bytes_in_last_chunk = bytes;
+        return chunks.back().data;
+    }
+    if (chunks.empty() ||
+        used_bytes_in_last_chunk + bytes > chunks.back().size) {
+        add_chunk(CHUNK_BYTES);
+    }
+    void *result = chunks.back().data + used_bytes_in_last_chunk;
+    used_bytes_in_last_chunk += bytes;
+    return result;
+}
+
+size_t MappedFileArena::get_mapped_bytes() const {
+    size_t bytes = 0;
+    for (const Chunk &chunk : chunks) {
+        bytes += chunk.size;
+    }
+    return bytes;
+}
+}
@@ -0,0 +1,108 @@
+#ifndef UTILS_MAPPED_FILE_ARENA_H
+#define UTILS_MAPPED_FILE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Memory arena whose memory is backed by files on disk. The arena maps
+  temporary files of CHUNK_BYTES each (larger requests get a chunk of their
+  own) and hands out memory from the most recent chunk. The files are
+  deleted right after they are created, so they disappear when the arena is
+  destroyed or the process ends.
+
+  Memory can only be released as a whole when the arena is destroyed. This
+  suits containers like SegmentedArrayVector that only free their segments
+  in their destructor.
+
+  The most recently created chunks may use RAM freely. Whenever a chunk is
+  created, the chunk that falls out of the RAM budget and one further older
+  chunk (in round-robin order) are written back and dropped from RAM. Data
+  in dropped chunks is read from disk again when it is accessed. For data
+  that is appended and mostly accessed while it is recent (such as the
+  states of a search), this keeps the working set in RAM.
+
+  Only supported on Linux and macOS.
+*/
+class MappedFileArena {
+    static const size_t CHUNK_BYTES = 64 * 1024 * 1024;
+
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    const std::string directory;
+    const size_t num_resident_chunks;
+    std::vector<Chunk> chunks;
+    size_t used_bytes_in_last_chunk;
+    size_t next_chunk_to_release;
+
+    void add_chunk(size_t size);
+    void release_chunk(size_t index);
+public:
+    MappedFileArena(const std::string &directory, size_t ram_budget_in_bytes);
+    ~MappedFileArena();
+
+    MappedFileArena(const MappedFileArena &) = delete;
+    MappedFileArena &operator=(const MappedFileArena &) = delete;
+
+    void *allocate(size_t bytes);
+
+    size_t get_mapped_bytes() const;
+};
+
+/*
+  Allocator for standard-conforming containers. Without an arena, it
+  allocates from the heap like std::allocator. With an arena, it allocates
+  from the arena and deallocation is a no-op.
+*/
+template<class T>
+class MappedFileAllocator {
+    template<class U>
+    friend class MappedFileAllocator;
+
+    std::shared_ptr<MappedFileArena> arena;
+public:
+    using value_type = T;
+
+    MappedFileAllocator() = default;
+
+    explicit MappedFileAllocator(const std::shared_ptr<MappedFileArena> &arena)
+        : arena(arena) {
+    }
+
+    template<class U>
+    MappedFileAllocator(const MappedFileAllocator<U> &other)
+        : arena(other.arena) {
+    }
+
+    T *allocate(size_t n) {
+        if (arena) {
+            return static_cast<T *>(arena->allocate(n * sizeof(T)));
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (!arena) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    template<class U>
+    bool operator==(const MappedFileAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+
+    template<class U>
+    bool operator!=(const MappedFileAllocator<U> &other) const {
+        return !(*this == other);
+    }
+};
+}
+
+#endif
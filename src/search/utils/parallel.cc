@@ -0,0 +1,125 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+int get_num_threads(int num_threads) {
+    assert(num_threads >= 0);
+    if (num_threads == 0) {
+        // hardware_concurrency() returns 0 if the value is not computable.
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+int get_chunk_begin(int chunk, int num_items, int num_chunks) {
+    assert(num_chunks > 0);
+    return static_cast<int>(static_cast<long long>(num_items) * chunk / num_chunks);
+}
+
+int run_in_chunks(
+    int num_items, int num_threads,
+    const function<void(int chunk, int begin, int end)> &func) {
+    int num_chunks = max(1, min(get_num_threads(num_threads), num_items));
+    if (num_chunks == 1) {
+        func(0, 0, num_items);
+        return 1;
+    }
+    vector<thread> threads;
+    threads.reserve(num_chunks - 1);
+    for (int chunk = 1; chunk < num_chunks; ++chunk) {
+        threads.emplace_back(
+            func, chunk, get_chunk_begin(chunk, num_items, num_chunks),
+            get_chunk_begin(chunk + 1, num_items, num_chunks));
+    }
+    // The calling thread handles the first chunk.
+    func(0, 0, get_chunk_begin(1, num_items, num_chunks));
+    for (thread &t : threads) {
+        t.join();
+    }
+    return num_chunks;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+    : func(nullptr),
+      num_tasks(0),
+      next_task(0),
+      num_busy_threads(0),
+      batch(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    threads.reserve(num_threads - 1);
+    for (int worker = 1; worker < num_threads; ++worker) {
+        threads.emplace_back(&ThreadPool::run_thread, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(pool_mutex);
+        shutting_down = true;
+    }
+    batch_started.notify_all();
+    for (thread &t : threads) {
+        t.join();
+    }
+}
+
+void ThreadPool::run_tasks(int worker, unique_lock<mutex> &lock) {
+    /*
+      Tasks are handed out under the lock. This is cheap compared to the
+      tasks we use the pool for (e.g., computing heuristic values).
+    */
+    while (next_task < num_tasks) {
+        int task = next_task++;
+        lock.unlock();
+        (*func)(worker, task);
+        lock.lock();
+    }
+}
+
+void ThreadPool::run_thread(int worker) {
+    unique_lock<mutex> lock(pool_mutex);
+    /*
+      The first batch can start before this thread runs, so we must not
+      initialize last_batch with the current value of batch.
+    */
+    int last_batch = 0;
+    while (true) {
+        batch_started.wait(lock, [&]() {
+                               return shutting_down || batch != last_batch;
+                           });
+        if (shutting_down) {
+            return;
+        }
+        last_batch = batch;
+        run_tasks(worker, lock);
+        if (--num_busy_threads == 0) {
+            batch_finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(
+    int num_tasks_, const function<void(int worker, int task)> &func_) {
+    if (threads.empty() || num_tasks_ <= 1) {
+        for (int task = 0; task < num_tasks_; ++task) {
+            func_(0, task);
+        }
+        return;
+    }
+    unique_lock<mutex> lock(pool_mutex);
+    func = &func_;
+    num_tasks = num_tasks_;
+    next_task = 0;
+    num_busy_threads = threads.size();
+    ++batch;
+    batch_started.notify_all();
+    run_tasks(0, lock);
+    batch_finished.wait(lock, [&]() {return num_busy_threads == 0;});
+    func = nullptr;
+}
+}
@@ -0,0 +1,78 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Return the number of worker threads for a requested number of threads,
+  where 0 means one thread per hardware thread.
+*/
+extern int get_num_threads(int num_threads);
+
+/*
+  Split [0, num_items) into num_chunks contiguous chunks of (almost) equal
+  size. The chunk boundaries only depend on num_items and num_chunks.
+*/
+extern int get_chunk_begin(int chunk, int num_items, int num_chunks);
+
+/*
+  Call func(chunk, begin, end) for every chunk [begin, end) of
+  [0, num_items). With num_threads > 1, there is one chunk per thread and
+  the chunks are processed concurrently, so func must only write to data
+  owned by its chunk. Callers that merge per-chunk results in chunk order
+  obtain the same result for every number of threads.
+
+  Returns the number of chunks.
+*/
+extern int run_in_chunks(
+    int num_items, int num_threads,
+    const std::function<void(int chunk, int begin, int end)> &func);
+
+/*
+  Pool of threads for running many small batches of tasks, where starting
+  new threads for every batch (as run_in_chunks does) would be too
+  expensive. The threads wait for work between batches.
+
+  run(num_tasks, func) calls func(worker, task) for every task in
+  [0, num_tasks) and returns when all calls are finished. Tasks are handed
+  out dynamically, so which worker runs which task varies between runs.
+  The calling thread takes part as worker 0, the pool threads are workers
+  1 to num_threads - 1. Every worker processes its tasks sequentially, so
+  func can use data owned by the worker without synchronization.
+*/
+class ThreadPool {
+    std::vector<std::thread> threads;
+    std::mutex pool_mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+    const std::function<void(int worker, int task)> *func;
+    int num_tasks;
+    int next_task;
+    int num_busy_threads;
+    // Incremented for every batch, so that waiting threads notice new work.
+    int batch;
+    bool shutting_down;
+
+    void run_tasks(int worker, std::unique_lock<std::mutex> &lock);
+    void run_thread(int worker);
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const {
+        return threads.size() + 1;
+    }
+
+    void run(int num_tasks, const std::function<void(int worker, int task)> &func);
+};
+}
+
+#endif